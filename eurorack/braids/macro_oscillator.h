@@ -64,6 +64,8 @@ class MacroOscillator {
     shape_ = shape;
   }
 
+  inline MacroOscillatorShape shape() const { return shape_; }
+
   inline void set_pitch(int16_t pitch) {
     pitch_ = pitch;
   }
@@ -0,0 +1,97 @@
+// Copyright 2026 The mi-UGens contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+// 
+// See http://creativecommons.org/licenses/MIT/ for more information.
+//
+// -----------------------------------------------------------------------------
+//
+// Decimation filters, from the internal sample rate of the oscillator (around
+// 96kHz) down to the output sample rate.
+
+#ifndef BRAIDS_SAMPLE_RATE_CONVERSION_FILTERS_H_
+#define BRAIDS_SAMPLE_RATE_CONVERSION_FILTERS_H_
+
+#include "stmlib/dsp/sample_rate_converter.h"
+
+namespace stmlib {
+
+// Generated with:
+// 1 * scipy.signal.remez(48, [0, 0.400000 / 2, 0.580000 / 2, 0.5], [1, 0], weight=[1, 10])
+template<>
+struct SRC_FIR<SRC_DOWN, 2, 48> {
+  template<int32_t i> inline float Read() const {
+    const float h[] = {
+       3.899477536e-05,  4.257774737e-04,  4.737842012e-04, -6.351575894e-04,
+      -1.237420913e-03,  9.395300805e-04,  2.659937014e-03, -1.099125864e-03,
+      -4.956578388e-03,  8.711794010e-04,  8.390583720e-03,  1.106379643e-04,
+      -1.327707953e-02, -2.391175659e-03,  2.007110397e-02,  6.840842379e-03,
+      -2.964601318e-02, -1.512179668e-02,  4.421524150e-02,  3.148448006e-02,
+      -7.140835086e-02, -7.333836019e-02,  1.608322164e-01,  4.361024693e-01,
+    };
+    return h[i];
+  }
+};
+
+// Generated with:
+// 1 * scipy.signal.remez(72, [0, 0.400000 / 3, 0.580000 / 3, 0.5], [1, 0], weight=[1, 10])
+template<>
+struct SRC_FIR<SRC_DOWN, 3, 72> {
+  template<int32_t i> inline float Read() const {
+    const float h[] = {
+      -1.348259444e-05,  1.339320761e-04,  3.268453758e-04,  3.727998709e-04,
+       3.792548924e-05, -5.708395394e-04, -8.877960114e-04, -3.280904797e-04,
+       9.533358519e-04,  1.812578474e-03,  9.986246539e-04, -1.362486867e-03,
+      -3.244237982e-03, -2.259805894e-03,  1.679934528e-03,  5.299853881e-03,
+       4.395544136e-03, -1.712361737e-03, -8.103377263e-03, -7.795482477e-03,
+       1.162861170e-03,  1.182347002e-02,  1.306442654e-02,  4.427625042e-04,
+      -1.679650705e-02, -2.135985891e-02, -3.994728813e-03,  2.392271289e-02,
+       3.558717074e-02,  1.175329339e-02, -3.634106904e-02, -6.642750774e-02,
+      -3.332084569e-02,  7.305867246e-02,  2.107365022e-01,  3.072905069e-01,
+    };
+    return h[i];
+  }
+};
+
+// Generated with:
+// 1 * scipy.signal.remez(96, [0, 0.400000 / 4, 0.580000 / 4, 0.5], [1, 0], weight=[1, 10])
+template<>
+struct SRC_FIR<SRC_DOWN, 4, 96> {
+  template<int32_t i> inline float Read() const {
+    const float h[] = {
+      -2.631097709e-05,  5.181983693e-05,  1.518210511e-04,  2.612699355e-04,
+       2.925696235e-04,  1.640465167e-04, -1.319306232e-04, -4.812791973e-04,
+      -6.708003016e-04, -4.977838301e-04,  7.791663891e-05,  8.348908994e-04,
+       1.339158885e-03,  1.161814273e-03,  1.747377185e-04, -1.256606278e-03,
+      -2.351293875e-03, -2.296890273e-03, -7.759247435e-04,  1.676652086e-03,
+       3.771843204e-03,  4.086086016e-03,  1.938840788e-03, -1.973410047e-03,
+      -5.660581991e-03, -6.768019707e-03, -3.968077884e-03,  1.956403287e-03,
+       8.092897628e-03,  1.070377812e-02,  7.345809991e-03, -1.323036905e-03,
+      -1.122925703e-02, -1.658255812e-02, -1.299898045e-02, -4.829570372e-04,
+       1.553377676e-02,  2.612374510e-02,  2.328257039e-02,  4.852051292e-03,
+      -2.267570391e-02, -4.539158992e-02, -4.731255181e-02, -1.777163841e-02,
+       4.252683091e-02,  1.198957676e-01,  1.917391688e-01,  2.349211565e-01,
+    };
+    return h[i];
+  }
+};
+
+}  // namespace stmlib
+
+#endif  // BRAIDS_SAMPLE_RATE_CONVERSION_FILTERS_H_
@@ -62,6 +62,7 @@ class AudioBuffer {
   AudioBuffer() { }
   ~AudioBuffer() { }
   
+  // The memory has to be filled with silence_byte() beforehand.
   void Init(
       void* buffer,
       int32_t size,
@@ -72,17 +73,13 @@ class AudioBuffer {
     write_head_ = 0;
     quantization_error_ = 0.0f;
     crossfade_counter_ = 0;
-    if (resolution == RESOLUTION_16_BIT) {
-      std::fill(&s16_[0], &s16_[size], 0);
-    } else {
-      std::fill(
-          &s8_[0],
-          &s8_[size],
-          resolution == RESOLUTION_8_BIT_MU_LAW ? 127 : 0);
-    }
     tail_ = tail_buffer;
   }
   
+  static inline uint8_t silence_byte() {
+    return resolution == RESOLUTION_8_BIT_MU_LAW ? 127 : 0;
+  }
+  
   inline void Resync(int32_t head) {
     write_head_ = head;
     crossfade_counter_ = 0;
@@ -276,7 +273,46 @@ class AudioBuffer {
     const float b_neg = w + a;
     return ((((a * t) - b_neg) * t + c) * t + x0) * scale;
   }
-  
+
+  // Fetches the four points ReadHermite() interpolates between, as raw
+  // integers, so that the conversion and the interpolation itself can be done
+  // on several grains at once.
+  inline void ReadHermitePoints(
+      int32_t integral,
+      int32_t* xm1,
+      int32_t* x0,
+      int32_t* x1,
+      int32_t* x2) const {
+    if (integral >= size_) {
+      integral -= size_;
+    }
+
+    if (resolution == RESOLUTION_16_BIT) {
+      *xm1 = s16_[integral];
+      *x0 = s16_[integral + 1];
+      *x1 = s16_[integral + 2];
+      *x2 = s16_[integral + 3];
+    } else if (resolution == RESOLUTION_8_BIT_MU_LAW) {
+      *xm1 = MuLaw2Lin(s8_[integral]);
+      *x0 = MuLaw2Lin(s8_[integral + 1]);
+      *x1 = MuLaw2Lin(s8_[integral + 2]);
+      *x2 = MuLaw2Lin(s8_[integral + 3]);
+    } else {
+      *xm1 = s8_[integral];
+      *x0 = s8_[integral + 1];
+      *x1 = s8_[integral + 2];
+      *x2 = s8_[integral + 3];
+    }
+  }
+
+  // Scale applied to the raw samples returned by ReadHermitePoints().
+  static inline float sample_scale() {
+    return resolution == RESOLUTION_16_BIT ||
+        resolution == RESOLUTION_8_BIT_MU_LAW
+        ? 1.0f / 32768.0f
+        : 1.0f / 128.0f;
+  }
+
   inline int32_t size() const { return size_; }
   inline int32_t head() const { return write_head_; }
   
@@ -24,38 +24,43 @@
 //
 // -----------------------------------------------------------------------------
 //
-// Single grain synthesis.
+// Grain synthesis. The grains are stored as a structure of arrays, and the
+// active ones are rendered kSimdWidth at a time: the buffer reads and the
+// envelopes are computed grain by grain, then the Hermite interpolation and
+// the panning on whole vectors of grains.
 
 #ifndef CLOUDS_DSP_GRAIN_H_
 #define CLOUDS_DSP_GRAIN_H_
 
 #include "stmlib/stmlib.h"
 
+#include <algorithm>
+
 #include "stmlib/dsp/dsp.h"
+#include "stmlib/dsp/simd.h"
 
 #include "clouds/dsp/audio_buffer.h"
-
+#include "clouds/dsp/frame.h"
 #include "clouds/resources.h"
 
 namespace clouds {
 
-enum GrainQuality {
-  GRAIN_QUALITY_LOW,
-  GRAIN_QUALITY_MEDIUM,
-  GRAIN_QUALITY_HIGH
-};
+const int32_t kMaxNumGrains = 64;
 
-class Grain {
+class GrainPool {
  public:
-  Grain() { }
-  ~Grain() { }
+  GrainPool() { }
+  ~GrainPool() { }
 
   void Init() {
-    active_ = false;
-    envelope_phase_ = 2.0f;
+    for (int32_t i = 0; i < kMaxNumGrains; ++i) {
+      envelope_phase_[i] = 2.0f;
+      active_[i] = false;
+    }
   }
 
   void Start(
+      int32_t i,
       int32_t pre_delay,
       int32_t buffer_size,
       int32_t start,
@@ -63,141 +68,225 @@ class Grain {
       int32_t phase_increment,
       float window_shape,
       float gain_l,
-      float gain_r,
-      GrainQuality recommended_quality) {
-    pre_delay_ = pre_delay;
-    width_ = width;
-    first_sample_ = (start + buffer_size) % buffer_size;
-    phase_increment_ = phase_increment;
-    phase_ = 0;
-    envelope_phase_ = 0.0f;
-    envelope_phase_increment_ = 2.0f / static_cast<float>(width);
+      float gain_r) {
+    pre_delay_[i] = pre_delay;
+    first_sample_[i] = (start + buffer_size) % buffer_size;
+    phase_increment_[i] = phase_increment;
+    phase_[i] = 0;
+    envelope_phase_[i] = 0.0f;
+    envelope_phase_increment_[i] = 2.0f / static_cast<float>(width);
     if (window_shape >= 0.5f) {
-      envelope_smoothness_ = (window_shape - 0.5f) * 2.0f;
-      envelope_slope_ = 0.0f;
+      envelope_smoothness_[i] = (window_shape - 0.5f) * 2.0f;
+      envelope_slope_[i] = 0.0f;
     } else {
-      envelope_smoothness_ = 0.0f;
-      envelope_slope_ = 0.5f / (window_shape + 0.01f);
+      envelope_smoothness_[i] = 0.0f;
+      envelope_slope_[i] = 0.5f / (window_shape + 0.01f);
     }
-    active_ = true;
-    gain_l_ = gain_l;
-    gain_r_ = gain_r;
-    recommended_quality_ = recommended_quality;
+    active_[i] = true;
+    gain_l_[i] = gain_l;
+    gain_r_[i] = gain_r;
   }
-  
-  template<bool use_lut_for_envelope, GrainQuality quality>
-  inline void RenderEnvelope(float* destination, size_t size) {
-    const float increment = envelope_phase_increment_;
-    const float smoothness = envelope_smoothness_;
-    const float slope = envelope_slope_;
-
-    float phase = envelope_phase_;
-    while (size--) {
-      float gain = phase;
-      gain = gain >= 1.0f ? 2.0f - gain : gain;
-      if (use_lut_for_envelope) {
-        if (quality == GRAIN_QUALITY_HIGH) {
-          float window = 0.0f;
-          window = stmlib::Interpolate(lut_window, gain, 4096.0f);
-          gain += smoothness * (window - gain);
-        }
-      } else {
-        if (quality >= GRAIN_QUALITY_MEDIUM) {
-          gain *= slope;
-          if (gain >= 1.0f) gain = 1.0f;
-        }
+
+  inline bool active(int32_t i) const { return active_[i]; }
+
+  // Adds the first num_grains grains to the interleaved stereo destination.
+  // The active grains are packed kSimdWidth at a time, so that a sparse pool
+  // costs no more vectors than a dense one.
+  template<int32_t num_channels, Resolution resolution>
+  void OverlapAdd(
+      const AudioBuffer<resolution>* buffer,
+      int32_t num_grains,
+      float* destination,
+      size_t size) {
+    const size_t width = stmlib::kSimdWidth;
+    std::fill(&mix_l_[0], &mix_l_[size * width], 0.0f);
+    std::fill(&mix_r_[0], &mix_r_[size * width], 0.0f);
+
+    int32_t num_active_grains = 0;
+    for (int32_t i = 0; i < num_grains; ++i) {
+      if (active_[i]) {
+        active_grains_[num_active_grains++] = i;
       }
-      phase += increment;
-      if (phase >= 2.0f) {
-        *destination = -1.0f;
-        break;
+    }
+
+    for (int32_t first = 0; first < num_active_grains; first += width) {
+      for (size_t lane = 0; lane < width; ++lane) {
+        if (first + static_cast<int32_t>(lane) < num_active_grains) {
+          int32_t i = active_grains_[first + lane];
+          lane_gain_l_[lane] = gain_l_[i];
+          lane_gain_r_[lane] = gain_r_[i];
+          Gather<num_channels>(buffer, i, lane, size);
+        } else {
+          lane_gain_l_[lane] = lane_gain_r_[lane] = 0.0f;
+          Silence<num_channels>(lane, 0, size);
+        }
       }
-      *destination++ = gain;
+      Mix<num_channels>(size, AudioBuffer<resolution>::sample_scale());
+    }
+
+    for (size_t t = 0; t < size; ++t) {
+      *destination++ += stmlib::SimdFloat::Load(&mix_l_[t * width]).Sum();
+      *destination++ += stmlib::SimdFloat::Load(&mix_r_[t * width]).Sum();
     }
-    envelope_phase_ = phase;
   }
-  
-  template<int32_t num_channels, GrainQuality quality, Resolution resolution>
-  inline void OverlapAdd(
+
+ private:
+  // Advances active grain i by size samples, and writes its envelope, its
+  // fractional read position and the four samples surrounding it in the
+  // given lane of the staging arrays. Silent samples are written as zeros.
+  template<int32_t num_channels, Resolution resolution>
+  inline void Gather(
       const AudioBuffer<resolution>* buffer,
-      float* destination,
-      float* envelope,
+      int32_t i,
+      size_t lane,
       size_t size) {
-    if (!active_) {
-      return;
-    }
-    // Rendering is done on 32-sample long blocks. The pre-delay allows grains
-    // to start at arbitrary samples within a block, rather than at block
-    // boundaries.
-    while (pre_delay_ && size) {
-      destination += 2;
-      --size;
-      --pre_delay_;
+    const size_t width = stmlib::kSimdWidth;
+    // Rendering is done on 32-sample long blocks. The pre-delay allows
+    // grains to start at arbitrary samples within a block, rather than at
+    // block boundaries.
+    int32_t pre_delay = std::min(pre_delay_[i], static_cast<int32_t>(size));
+    pre_delay_[i] -= pre_delay;
+    Silence<num_channels>(lane, 0, pre_delay);
+
+    const int32_t phase_increment = phase_increment_[i];
+    const int32_t first_sample = first_sample_[i];
+    const float envelope_phase_increment = envelope_phase_increment_[i];
+    const float smoothness = envelope_smoothness_[i];
+    const float slope = envelope_slope_[i];
+    int32_t phase = phase_[i];
+    float envelope_phase = envelope_phase_[i];
+    size_t t = pre_delay;
+    for (; t < size; ++t) {
+      float gain = envelope_phase >= 1.0f
+          ? 2.0f - envelope_phase
+          : envelope_phase;
+      if (smoothness != 0.0f) {
+        float window = stmlib::Interpolate(lut_window, gain, 4096.0f);
+        gain += smoothness * (window - gain);
+      } else {
+        gain *= slope;
+        if (gain >= 1.0f) gain = 1.0f;
+      }
+      envelope_phase += envelope_phase_increment;
+      if (envelope_phase >= 2.0f) {
+        active_[i] = false;
+        break;
+      }
+      const size_t k = t * width + lane;
+      int32_t sample_index = first_sample + (phase >> 16);
+      envelope_[k] = gain;
+      fractional_[k] = phase & 65535;
+      for (int32_t channel = 0; channel < num_channels; ++channel) {
+        buffer[channel].ReadHermitePoints(
+            sample_index,
+            &xm1_[channel][k],
+            &x0_[channel][k],
+            &x1_[channel][k],
+            &x2_[channel][k]);
+      }
+      phase += phase_increment;
     }
-    
-    // Pre-render the envelope in one pass.
-    if (envelope_smoothness_ == 0.0f) {
-      RenderEnvelope<false, quality>(envelope, size);
-    } else {
-      RenderEnvelope<true, quality>(envelope, size);
+    phase_[i] = phase;
+    envelope_phase_[i] = envelope_phase;
+    Silence<num_channels>(lane, t, size);
+  }
+
+  template<int32_t num_channels>
+  inline void Silence(size_t lane, size_t start, size_t end) {
+    const size_t width = stmlib::kSimdWidth;
+    for (size_t t = start; t < end; ++t) {
+      const size_t k = t * width + lane;
+      envelope_[k] = 0.0f;
+      fractional_[k] = 0;
+      for (int32_t channel = 0; channel < num_channels; ++channel) {
+        xm1_[channel][k] = x0_[channel][k] = 0;
+        x1_[channel][k] = x2_[channel][k] = 0;
+      }
     }
-    
-    const int32_t phase_increment = phase_increment_;
-    const int32_t first_sample = first_sample_;
-    const float gain_l = gain_l_;
-    const float gain_r = gain_r_;
-    int32_t phase = phase_;
-    while (size--) {
-      int32_t sample_index = first_sample + (phase >> 16);
-      
-      float gain = *envelope++;
-      if (gain == -1.0f) {
-        active_ = false;
-        break;
+  }
+
+  // Interpolates, windows and pans the staged samples, and adds them to the
+  // mix.
+  template<int32_t num_channels>
+  inline void Mix(size_t size, float sample_scale) {
+    using stmlib::SimdFloat;
+    const size_t width = stmlib::kSimdWidth;
+    const SimdFloat scale = SimdFloat::Broadcast(sample_scale);
+    const SimdFloat half = SimdFloat::Broadcast(0.5f);
+    const SimdFloat one = SimdFloat::Broadcast(1.0f);
+    const SimdFloat gain_l = SimdFloat::Load(lane_gain_l_);
+    const SimdFloat gain_r = SimdFloat::Load(lane_gain_r_);
+    const SimdFloat cross_l = one - gain_l;
+    const SimdFloat cross_r = one - gain_r;
+
+    for (size_t t = 0; t < size; ++t) {
+      const size_t k = t * width;
+      const SimdFloat envelope = SimdFloat::Load(&envelope_[k]) * scale;
+      const SimdFloat fractional = SimdFloat::Load(&fractional_[k]) *
+          SimdFloat::Broadcast(1.0f / 65536.0f);
+
+      SimdFloat s[num_channels];
+      for (int32_t channel = 0; channel < num_channels; ++channel) {
+        // Laurent de Soras's Hermite interpolator.
+        const SimdFloat xm1 = SimdFloat::Load(&xm1_[channel][k]);
+        const SimdFloat x0 = SimdFloat::Load(&x0_[channel][k]);
+        const SimdFloat x1 = SimdFloat::Load(&x1_[channel][k]);
+        const SimdFloat x2 = SimdFloat::Load(&x2_[channel][k]);
+        const SimdFloat c = (x1 - xm1) * half;
+        const SimdFloat v = x0 - x1;
+        const SimdFloat w = c + v;
+        const SimdFloat a = w + v + (x2 - x0) * half;
+        const SimdFloat b_neg = w + a;
+        s[channel] = ((((a * fractional) - b_neg) * fractional + c) *
+            fractional + x0) * envelope;
       }
 
-      float l = buffer[0].template Read<InterpolationMethod(quality)>(
-          sample_index, phase & 65535) * gain;
+      SimdFloat l = SimdFloat::Load(&mix_l_[k]);
+      SimdFloat r = SimdFloat::Load(&mix_r_[k]);
       if (num_channels == 1) {
-        *destination++ += l * gain_l;
-        *destination++ += l * gain_r;
-      } else if (num_channels == 2) {
-        float r = buffer[1].template Read<InterpolationMethod(quality)>(
-            sample_index, phase & 65535) * gain;
-        *destination++ += l * gain_l + r * (1.0f - gain_r);
-        *destination++ += r * gain_r + l * (1.0f - gain_l);
+        l = l + s[0] * gain_l;
+        r = r + s[0] * gain_r;
+      } else {
+        l = l + s[0] * gain_l + s[num_channels - 1] * cross_r;
+        r = r + s[num_channels - 1] * gain_r + s[0] * cross_l;
       }
-      phase += phase_increment;
+      l.Store(&mix_l_[k]);
+      r.Store(&mix_r_[k]);
     }
-    phase_ = phase;
-  }
-  
-  inline bool active() { return active_; }
-  
-  inline GrainQuality recommended_quality() const {
-    return recommended_quality_;
   }
 
- private:
-  int32_t first_sample_;
-  int32_t width_;
-  int32_t phase_;
-  int32_t phase_increment_;
-  int32_t pre_delay_;
+  static const size_t kStagingSize = kMaxBlockSize * stmlib::kSimdWidth;
+
+  int32_t first_sample_[kMaxNumGrains];
+  int32_t phase_[kMaxNumGrains];
+  int32_t phase_increment_[kMaxNumGrains];
+  int32_t pre_delay_[kMaxNumGrains];
+
+  float envelope_smoothness_[kMaxNumGrains];
+  float envelope_slope_[kMaxNumGrains];
+  float envelope_phase_[kMaxNumGrains];
+  float envelope_phase_increment_[kMaxNumGrains];
+
+  float gain_l_[kMaxNumGrains];
+  float gain_r_[kMaxNumGrains];
+
+  bool active_[kMaxNumGrains];
+  int32_t active_grains_[kMaxNumGrains];
 
-  float envelope_smoothness_;
-  float envelope_slope_;
-  float envelope_phase_;
-  float envelope_phase_increment_;
+  float lane_gain_l_[stmlib::kSimdWidth];
+  float lane_gain_r_[stmlib::kSimdWidth];
 
-  float gain_l_;
-  float gain_r_;
+  float envelope_[kStagingSize];
+  int32_t fractional_[kStagingSize];
+  int32_t xm1_[kMaxNumChannels][kStagingSize];
+  int32_t x0_[kMaxNumChannels][kStagingSize];
+  int32_t x1_[kMaxNumChannels][kStagingSize];
+  int32_t x2_[kMaxNumChannels][kStagingSize];
 
-  bool active_;
-  
-  GrainQuality recommended_quality_;
+  float mix_l_[kStagingSize];
+  float mix_r_[kStagingSize];
 
-  DISALLOW_COPY_AND_ASSIGN(Grain);
+  DISALLOW_COPY_AND_ASSIGN(GrainPool);
 };
 
 }  // namespace clouds
@@ -61,6 +61,7 @@ void GranularProcessor::Init(
   
   previous_playback_mode_ = PLAYBACK_MODE_LAST;
   reset_buffers_ = true;
+  cleared_size_ = 0;
   dry_wet_ = 0.0f;
     
     sr_ = 48000.f;      // vb, init sample rate
@@ -75,6 +76,34 @@ void GranularProcessor::ResetFilters() {
   }
 }
 
+bool GranularProcessor::ClearSampleMemory(
+    void** buffer,
+    const size_t* buffer_size) {
+  uint8_t silence = resolution() == 8
+      ? AudioBuffer<RESOLUTION_8_BIT_MU_LAW>::silence_byte()
+      : AudioBuffer<RESOLUTION_16_BIT>::silence_byte();
+  size_t slice = kClearSliceSize;
+  size_t offset = cleared_size_;
+  size_t total = 0;
+  for (int32_t i = 0; i < num_channels_; ++i) {
+    total += buffer_size[i];
+    if (offset >= buffer_size[i]) {
+      offset -= buffer_size[i];
+      continue;
+    }
+    size_t size = min(buffer_size[i] - offset, slice);
+    memset(static_cast<uint8_t*>(buffer[i]) + offset, silence, size);
+    cleared_size_ += size;
+    slice -= size;
+    offset = 0;
+  }
+  if (cleared_size_ < total) {
+    return false;
+  }
+  cleared_size_ = 0;
+  return true;
+}
+
 void GranularProcessor::ProcessGranular(
     FloatFrame* input,
     FloatFrame* output,
@@ -381,7 +410,9 @@ bool GranularProcessor::LoadPersistentData(const uint32_t* data) {
       // We can force a switch to this mode, and once everything has been
       // initialized for this mode, we continue with the loop to copy the
       // actual buffer data - with all state variables correctly initialized.
-      Prepare();
+      do {
+        Prepare();
+      } while (reset_buffers_ || previous_playback_mode_ != playback_mode_);
       GetPersistentData(block, &num_blocks);
     }
   }
@@ -439,6 +470,13 @@ void GranularProcessor::Prepare() {
       workspace_size = buffer_size_[0] - buffer_size_[1];
       workspace = static_cast<uint8_t*>(buffer[0]) + buffer_size[0];
     }
+    // Process() stays silent until the sample memory is clear.
+    if (playback_mode_ == PLAYBACK_MODE_SPECTRAL) {
+      cleared_size_ = 0;
+    } else if (!ClearSampleMemory(buffer, buffer_size)) {
+      return;
+    }
+    
     float sr = sample_rate();
 
     BufferAllocator allocator(workspace, workspace_size);
@@ -48,6 +48,10 @@ namespace clouds {
 
 const int32_t kDownsamplingFactor = 2;
 
+// Sample memory cleared per call to Prepare(). The module's memory is cleared
+// at once, larger memories over several calls.
+const size_t kClearSliceSize = 131072;
+
 enum PlaybackMode {
   PLAYBACK_MODE_GRANULAR,
   PLAYBACK_MODE_STRETCH,
@@ -130,12 +134,18 @@ class GranularProcessor {
   }
   
   inline void set_num_channels(int32_t num_channels) {
-    reset_buffers_ = reset_buffers_ || num_channels_ != num_channels;
+    if (num_channels_ != num_channels) {
+      reset_buffers_ = true;
+      cleared_size_ = 0;
+    }
     num_channels_ = num_channels;
   }
   
   inline void set_low_fidelity(bool low_fidelity) {
-    reset_buffers_ = reset_buffers_ || low_fidelity != low_fidelity_;
+    if (low_fidelity != low_fidelity_) {
+      reset_buffers_ = true;
+      cleared_size_ = 0;
+    }
     low_fidelity_ = low_fidelity;
   }
   
@@ -180,6 +190,7 @@ class GranularProcessor {
   }
      
   void ResetFilters();
+  bool ClearSampleMemory(void** buffer, const size_t* buffer_size);
   void ProcessGranular(FloatFrame* input, FloatFrame* output, size_t size);
 
   PlaybackMode playback_mode_;
@@ -190,6 +201,7 @@ class GranularProcessor {
   bool silence_;
   bool bypass_;
   bool reset_buffers_;
+  size_t cleared_size_;
   float freeze_lp_;
   float dry_wet_;
     float sr_;          //vb
@@ -46,8 +46,6 @@
 
 namespace clouds {
 
-const int32_t kMaxNumGrains = 64;
-
 using namespace stmlib;
 
 class GranularSamplePlayer {
@@ -57,11 +55,8 @@ class GranularSamplePlayer {
   
   void Init(int32_t num_channels, int32_t max_num_grains) {
     max_num_grains_ = max_num_grains;
-    num_midfi_grains_ = 3 * max_num_grains / 4;
     gain_normalization_ = 1.0f;
-    for (int32_t i = 0; i < kMaxNumGrains; ++i) {
-      grains_[i].Init();
-    }
+    grains_.Init();
     num_grains_ = 0.0f;
     num_channels_ = num_channels;
     grain_size_hint_ = 1024.0f;
@@ -97,50 +92,24 @@ class GranularSamplePlayer {
       if (num_available_grains && seed) {
         --num_available_grains;
         int32_t index = available_grains_[num_available_grains];
-        GrainQuality quality;
-        if (num_available_grains < num_midfi_grains_) {
-          quality = GRAIN_QUALITY_MEDIUM;
-        } else {
-          quality = GRAIN_QUALITY_HIGH;
-        }
-        
-        Grain* g = &grains_[index];
         ScheduleGrain(
-            g,
+            index,
             parameters,
             t,
             buffer->size(),
-            buffer->head() - size + t,
-            quality);
+            buffer->head() - size + t);
         grain_rate_phasor_ = 0.0f;
         seed_trigger = false;
       }
     }
     
-    // Overlap grains.
+    // Overlap grains. All of them are rendered with Hermite interpolation and
+    // the full window.
     std::fill(&out[0], &out[size * 2], 0.0f);
-    float* e = envelope_buffer_;
-    for (int32_t i = 0; i < max_num_grains_; ++i) {
-      Grain* g = &grains_[i];
-      if (g->recommended_quality() == GRAIN_QUALITY_HIGH) {
-        if (num_channels_ == 1) {
-          g->OverlapAdd<1, GRAIN_QUALITY_HIGH>(buffer, out, e, size);
-        } else {
-          g->OverlapAdd<2, GRAIN_QUALITY_HIGH>(buffer, out, e, size);
-        }
-      } else if (g->recommended_quality() == GRAIN_QUALITY_MEDIUM) {
-        if (num_channels_ == 1) {
-          g->OverlapAdd<1, GRAIN_QUALITY_MEDIUM>(buffer, out, e, size);
-        } else {
-          g->OverlapAdd<2, GRAIN_QUALITY_MEDIUM>(buffer, out, e, size);
-        }
-      } else {
-        if (num_channels_ == 1) {
-          g->OverlapAdd<1, GRAIN_QUALITY_LOW>(buffer, out, e, size);
-        } else {
-          g->OverlapAdd<2, GRAIN_QUALITY_LOW>(buffer, out, e, size);
-        }
-      }
+    if (num_channels_ == 1) {
+      grains_.OverlapAdd<1>(buffer, max_num_grains_, out, size);
+    } else {
+      grains_.OverlapAdd<2>(buffer, max_num_grains_, out, size);
     }
     
     // Compute normalization factor.
@@ -167,7 +136,7 @@ class GranularSamplePlayer {
   int32_t FillAvailableGrainsList() {
     int32_t num_available_grains = 0;
     for (int32_t i = 0; i < max_num_grains_; ++i) {
-      if (!grains_[i].active()) {
+      if (!grains_.active(i)) {
         available_grains_[num_available_grains] = i;
         ++num_available_grains;
       }
@@ -176,12 +145,11 @@ class GranularSamplePlayer {
   }
   
   void ScheduleGrain(
-      Grain* grain,
+      int32_t index,
       const Parameters& parameters,
       int32_t pre_delay,
       int32_t buffer_size,
-      int32_t buffer_head,
-      GrainQuality quality) {
+      int32_t buffer_head) {
     float position = parameters.position;
     float pitch = parameters.pitch;
     float window_shape = parameters.granular.window_shape;
@@ -222,7 +190,8 @@ class GranularSamplePlayer {
     int32_t size = static_cast<int32_t>(grain_size) & ~1;
     int32_t start = buffer_head - static_cast<int32_t>(
         position * available + eaten_by_play_head);
-    grain->Start(
+    grains_.Start(
+        index,
         pre_delay,
         buffer_size,
         start,
@@ -230,13 +199,11 @@ class GranularSamplePlayer {
         static_cast<uint32_t>(pitch_ratio * 65536.0f),
         window_shape,
         gain_l,
-        gain_r,
-        quality);
+        gain_r);
     ONE_POLE(grain_size_hint_, grain_size, 0.1f);
   }
   
   int32_t max_num_grains_;
-  int32_t num_midfi_grains_;
   int32_t num_channels_;
 
   float num_grains_;
@@ -244,9 +211,8 @@ class GranularSamplePlayer {
   float grain_size_hint_;
   float grain_rate_phasor_;
   
-  Grain grains_[kMaxNumGrains];
+  GrainPool grains_;
   int32_t available_grains_[kMaxNumGrains];
-  float envelope_buffer_[kMaxBlockSize];
   
   DISALLOW_COPY_AND_ASSIGN(GranularSamplePlayer);
 };
@@ -35,6 +35,7 @@
 
 
 #include "stmlib/stmlib.h"
+#include "stmlib/resources.h"
 
 
 
@@ -53,7 +54,7 @@ extern const float src_filter_1x_2_45[];
 extern const float src_filter_1x_2_63[];
 extern const float src_filter_1x_2_91[];
 extern const int16_t lut_db[];
-extern const float lut_sin[];
+using stmlib::lut_sin;
 extern const float lut_window[];
 extern const float lut_xfade_in[];
 extern const float lut_xfade_out[];
@@ -31,29 +31,13 @@
 
 #include "stmlib/stmlib.h"
 
-#include <cmath>
-
 namespace elements {
   
 //static const float kSampleRate = 32000.0f;
 const size_t kMaxBlockSize = 16;
     
-    class Dsp {
-    private:
-        static float kSampleRate;
-        static float kSrFactor;
-        static float kIntervalCorrection;
-        
-    public:
-        static float getSr() { return kSampleRate; }
-        static float getSrFactor() { return kSrFactor; }
-        static float getIntervalCorrection() { return kIntervalCorrection; }
-        static void setSr(double newsr) {
-            kSampleRate = newsr;
-            kSrFactor = 32000.0f / kSampleRate;
-            kIntervalCorrection = logf(kSrFactor)/logf(2.0f)*12.0f;
-        }
-    };
+// The lookup tables are computed for the sample rate of the module.
+const float kNativeSampleRate = 32000.0f;
 
 }  // namespace elements
 
@@ -59,7 +59,7 @@ class Exciter {
   Exciter() { }
   ~Exciter() { }
   
-  void Init();
+  void Init(float sample_rate);
   
   inline void set_signature(float signature) {
     signature_ = signature;
@@ -122,6 +122,7 @@ class Exciter {
   uint32_t phase_;
   uint32_t delay_;
   uint32_t plectrum_delay_;
+  float sr_;
   
   static ProcessFn fn_table_[];
   
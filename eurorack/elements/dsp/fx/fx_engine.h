@@ -95,6 +95,15 @@ struct DataType<FORMAT_32_BIT> {
   }
 };
 
+// Format of the delay memory of the reverb.
+#ifdef ELEMENTS_FX_FLOAT_BUFFER
+const Format kFxBufferFormat = FORMAT_32_BIT;
+#else
+const Format kFxBufferFormat = FORMAT_16_BIT;
+#endif
+
+typedef DataType<kFxBufferFormat>::T FxBufferType;
+
 template<
     size_t size,
     Format format = FORMAT_12_BIT>
@@ -122,7 +122,7 @@ void FmOscillator::Process(
     float* destination,
     size_t size) {
     
-    frequency += Dsp::getIntervalCorrection();   // vb, pitch correction
+    frequency += interval_correction_;   // vb, pitch correction
     
     
   ratio = Interpolate(lut_fm_frequency_quantizer, ratio, 128.0f);
@@ -167,7 +167,8 @@ void FmOscillator::Process(
 }
 
 
-void OminousVoice::Init() {
+void OminousVoice::Init(float sample_rate) {
+  sr_factor_ = kNativeSampleRate / sample_rate;
   envelope_.Init();
   envelope_.set_adsr(0.5f, 0.5f, 0.5f, 0.5f);
   previous_gate_ = false;
@@ -175,7 +176,7 @@ void OminousVoice::Init() {
   
   for (size_t i = 0; i < kNumOscillators; ++i) {
     external_fm_state_[i] = 0.0f;
-    oscillator_[i].Init();
+    oscillator_[i].Init(sample_rate);
 
     // Downsampling is done mostly by the FIR, but since the stopband
     // attenuation peaks at -48dB, we can get a few extra dB of attenution with
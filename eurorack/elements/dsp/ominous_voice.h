@@ -121,9 +121,13 @@ class FmOscillator {
  public:
   FmOscillator() { }
   ~FmOscillator() { }
-  void Init() {
+  void Init(float sample_rate) {
+    // pitch correction for the actual sample rate
+    interval_correction_ = log2f(kNativeSampleRate / sample_rate) * 12.0f;
     fm_amount_ = 0.0f;
     previous_sample_ = 0.0f;
+    phase_carrier_ = 0;
+    phase_mod_ = 0;
   }
 
   void Process(float frequency,
@@ -162,6 +166,7 @@ class FmOscillator {
   
   float fm_amount_;
   float previous_sample_;
+  float interval_correction_;
   uint32_t phase_carrier_;
   uint32_t phase_mod_;
    
@@ -173,7 +178,7 @@ class OminousVoice {
   OminousVoice() { }
   ~OminousVoice() { }
   
-  void Init();
+  void Init(float sample_rate);
   void Process(
       const Patch& patch,
       float frequency,
@@ -227,7 +232,7 @@ class OminousVoice {
     }
     int32_t pitch = static_cast<int32_t>(midi_pitch * 256.0f);
     pitch = 32768 + stmlib::Clip16(pitch - 20480);
-    return lut_midi_to_f_high[pitch >> 8] * lut_midi_to_f_low[pitch & 0xff] * Dsp::getSrFactor(); // vb
+    return lut_midi_to_f_high[pitch >> 8] * lut_midi_to_f_low[pitch & 0xff] * sr_factor_; // vb
   }
   
   float external_fm_oversampled_[kOversamplingUp * kMaxBlockSize];
@@ -242,6 +247,7 @@ class OminousVoice {
   float damping_;
   
   float feedback_;
+  float sr_factor_;
   
   float osc_level_[kNumOscillators];
 
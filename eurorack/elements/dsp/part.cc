@@ -35,7 +35,9 @@ namespace elements {
 using namespace std;
 using namespace stmlib;
 
-void Part::Init(uint16_t* reverb_buffer) {
+void Part::Init(FxBufferType* reverb_buffer, float sample_rate) {
+  sr_ = sample_rate;
+  sr_factor_ = kNativeSampleRate / sample_rate;
   patch_.exciter_envelope_shape = 1.0f;
   patch_.exciter_bow_level = 0.0f;
   patch_.exciter_bow_timbre = 0.5f;
@@ -50,7 +52,7 @@ void Part::Init(uint16_t* reverb_buffer) {
   patch_.resonator_brightness = 0.5f;
   patch_.resonator_damping = 0.25f;
   patch_.resonator_position = 0.3f;
-  patch_.resonator_modulation_frequency = 0.5f / Dsp::getSr();
+  patch_.resonator_modulation_frequency = 0.5f / sr_;
   patch_.resonator_modulation_offset = 0.1f;
   patch_.reverb_diffusion = 0.625f;
   patch_.reverb_lp = 0.7f;
@@ -62,8 +64,8 @@ void Part::Init(uint16_t* reverb_buffer) {
   fill(&note_[0], &note_[kNumVoices], 69.0f);
   
   for (size_t i = 0; i < kNumVoices; ++i) {
-    voice_[i].Init();
-    ominous_voice_[i].Init();
+    voice_[i].Init(sample_rate);
+    ominous_voice_[i].Init(sample_rate);
   }
   
   reverb_.Init(reverb_buffer);
@@ -88,7 +90,7 @@ void Part::Seed(uint32_t* seed, size_t size) {
 
   x = static_cast<float>(signature & 7) / 8.0f;
   signature >>= 3;
-  patch_.resonator_modulation_frequency = (0.4f + 0.8f * x) / Dsp::getSr();
+  patch_.resonator_modulation_frequency = (0.4f + 0.8f * x) / sr_;
   
   x = static_cast<float>(signature & 7) / 8.0f;
   signature >>= 3;
@@ -182,7 +184,7 @@ void Part::Process(
       // Render the voice signal.
         //vb
         float freq = lut_midi_to_f_high[pitch >> 8] * lut_midi_to_f_low[pitch & 0xff];
-        freq *= Dsp::getSrFactor();
+        freq *= sr_factor_;
         
       voice_[i].Process(
           patch_,
@@ -54,7 +54,7 @@ class Part {
   Part() { }
   ~Part() { }
   
-  void Init(uint16_t* reverb_buffer);
+  void Init(FxBufferType* reverb_buffer, float sample_rate);
   
   void Process(
       const PerformanceState& performance_state,
@@ -110,6 +110,9 @@ class Part {
   
   ResonatorModel resonator_model_;
   
+  float sr_;
+  float sr_factor_;
+  
   DISALLOW_COPY_AND_ASSIGN(Part);
 };
 
@@ -41,17 +41,17 @@ namespace elements {
 using namespace std;
 using namespace stmlib;
 
-void Resonator::Init() {
-  for (size_t i = 0; i < kMaxModes; ++i) {
-    f_[i].Init();
-  }
+void Resonator::Init(float sample_rate) {
+  f_.Init();
+  fill(&partial_frequency_[0], &partial_frequency_[kMaxModes], 0.01f);
+  fill(&partial_q_[0], &partial_q_[kMaxModes], 100.0f);
 
   for (size_t i = 0; i < kMaxBowedModes; ++i) {
     f_bow_[i].Init();
     d_bow_[i].Init();
   }
   
-  set_frequency(220.0f / Dsp::getSr());
+  set_frequency(220.0f / sample_rate);
   set_geometry(0.25f);
   set_brightness(0.5f);
   set_damping(0.3f);
@@ -59,10 +59,23 @@ void Resonator::Init() {
   set_resolution(kMaxModes);
   
   bow_signal_ = 0.0f;
+  stale_frequencies_ = 2;
+  stale_qs_ = 2;
+  num_modes_ = 0;
 }
 
 size_t Resonator::ComputeFilters() {
   ++clock_divider_;
+  if (!stale_frequencies_) {
+    if (stale_qs_) {
+      --stale_qs_;
+      ComputeQs();
+    }
+    return num_modes_;
+  }
+  --stale_frequencies_;
+  stale_qs_ = max(stale_qs_ - 1, 0);
+  
   float stiffness = Interpolate(lut_stiffness, geometry_, 256.0f);
   float harmonic = frequency_;
   float stretch_factor = 1.0f; 
@@ -79,8 +92,9 @@ size_t Resonator::ComputeFilters() {
   float brightness = brightness_ * (1.0f - 0.2f * brightness_attenuation);
   float q_loss = brightness * (2.0f - brightness) * 0.85f + 0.15f;
   float q_loss_damping_rate = geometry_ * (2.0f - geometry_) * 0.1f;
-  size_t num_modes = 0;
-  for (size_t i = 0; i < min(kMaxModes, resolution_); ++i) {
+  num_modes_ = 0;
+  size_t num_filters = min(kMaxModes, resolution_);
+  for (size_t i = 0; i < num_filters; ++i) {
     // Update the first 24 modes every time (2kHz). The higher modes are
     // refreshed as a slowest rate.
     bool update = i <= 24 || ((i & 1) == (clock_divider_ & 1));
@@ -88,18 +102,11 @@ size_t Resonator::ComputeFilters() {
     if (partial_frequency >= 0.49f) {
       partial_frequency = 0.49f;
     } else {
-      num_modes = i + 1;
+      num_modes_ = i + 1;
     }
     if (update) {
-      f_[i].set_f_q<FREQUENCY_FAST>(
-          partial_frequency,
-          1.0f + partial_frequency * q);
-      if (i < kMaxBowedModes) {
-        size_t period = 1.0f / partial_frequency;
-        while (period >= kMaxDelayLineSize) period >>= 1;
-        d_bow_[i].set_delay(period);
-        f_bow_[i].set_g_q(f_[i].g(), 1.0f + partial_frequency * 1500.0f);
-      }
+      partial_frequency_[i] = partial_frequency;
+      partial_q_[i] = 1.0f + partial_frequency * q;
     }
     stretch_factor += stiffness;
     if (stiffness < 0.0f) {
@@ -115,7 +122,43 @@ size_t Resonator::ComputeFilters() {
     q *= q_loss;
   }
   
-  return num_modes;
+  // The modes which were not refreshed keep their previous settings.
+  f_.set_f_q<FREQUENCY_FAST>(partial_frequency_, partial_q_, num_filters);
+  for (size_t i = 0; i < min(kMaxBowedModes, num_filters); ++i) {
+    float partial_frequency = partial_frequency_[i];
+    size_t period = 1.0f / partial_frequency;
+    while (period >= kMaxDelayLineSize) period >>= 1;
+    d_bow_[i].set_delay(period);
+    f_bow_[i].set_g_q(f_.g(i), 1.0f + partial_frequency * 1500.0f);
+  }
+  
+  return num_modes_;
+}
+
+void Resonator::ComputeQs() {
+  // Same as above, for the Qs only: the partial frequencies are up to date.
+  float q = 500.0f * Interpolate(
+      lut_4_decades,
+      damping_ * 0.8f,
+      256.0f);
+  float brightness_attenuation = 1.0f - geometry_;
+  brightness_attenuation *= brightness_attenuation;
+  brightness_attenuation *= brightness_attenuation;
+  brightness_attenuation *= brightness_attenuation;
+  float brightness = brightness_ * (1.0f - 0.2f * brightness_attenuation);
+  float q_loss = brightness * (2.0f - brightness) * 0.85f + 0.15f;
+  float q_loss_damping_rate = geometry_ * (2.0f - geometry_) * 0.1f;
+  size_t num_filters = min(kMaxModes, resolution_);
+  for (size_t i = 0; i < num_filters; ++i) {
+    bool update = i <= 24 || ((i & 1) == (clock_divider_ & 1));
+    if (update) {
+      partial_q_[i] = 1.0f + partial_frequency_[i] * q;
+    }
+    q_loss += q_loss_damping_rate * (1.0f - q_loss);
+    q *= q_loss;
+  }
+  // The bowed modes only depend on the frequencies.
+  f_.set_q(partial_q_, num_filters);
 }
 
 void Resonator::Process(
@@ -129,6 +172,8 @@ void Resonator::Process(
   // Linearly interpolate position. This parameter is extremely sensitive to
   // zipper noise.
   float position_increment = (position_ - previous_position_) / size;
+  float center_amplitudes[kMaxModes];
+  float side_amplitudes[kMaxModes];
   while (size--) {
     float s;
 
@@ -162,22 +207,27 @@ void Resonator::Process(
     amplitudes.Start();
     aux_amplitudes.Start();
     for (size_t i = 0; i < num_modes; i++) {
-      s = f_[i].Process<FILTER_MODE_BAND_PASS>(input);
-      sum_center += s * amplitudes.Next();
-      sum_side += s * aux_amplitudes.Next();
+      center_amplitudes[i] = amplitudes.Next();
+      side_amplitudes[i] = aux_amplitudes.Next();
     }
+    f_.Process<FILTER_MODE_BAND_PASS>(
+        input,
+        center_amplitudes,
+        side_amplitudes,
+        num_modes,
+        &sum_center,
+        &sum_side);
     *sides++ = sum_side - sum_center;
     
     // Render bowed modes.
     float bow_signal = 0.0f;
     input += bow_signal_;
-    amplitudes.Start();
     for (size_t i = 0; i < num_banded_wg; ++i) {
       s = 0.99f * d_bow_[i].Read();
       bow_signal += s;
       s = f_bow_[i].Process<FILTER_MODE_BAND_PASS_NORMALIZED>(input + s);
       d_bow_[i].Write(s);
-      sum_center += s * amplitudes.Next() * 8.0f;
+      sum_center += s * center_amplitudes[i] * 8.0f;
     }
     bow_signal_ = BowTable(bow_signal, *bow_strength++);
     *center++ = sum_center;
@@ -37,6 +37,7 @@
 #include "elements/dsp/dsp.h"
 #include "stmlib/dsp/filter.h"
 #include "stmlib/dsp/delay_line.h"
+#include "stmlib/dsp/modal_bank.h"
 
 namespace elements {
 
@@ -49,7 +50,7 @@ class Resonator {
   Resonator() { }
   ~Resonator() { }
   
-  void Init();
+  void Init(float sample_rate);
   void Process(
       const float* bow_strength,
       const float* in,
@@ -57,20 +58,34 @@ class Resonator {
       float* sides,
       size_t size);
   
+  // The filter coefficients are only recomputed when one of the parameters
+  // below actually changes, see ComputeFilters().
   inline void set_frequency(float frequency) {
-    frequency_ = frequency;
+    if (frequency != frequency_) {
+      frequency_ = frequency;
+      stale_frequencies_ = 2;
+    }
   }
   
   inline void set_geometry(float geometry) {
-    geometry_ = geometry;
+    if (geometry != geometry_) {
+      geometry_ = geometry;
+      stale_frequencies_ = 2;
+    }
   }
   
   inline void set_brightness(float brightness) {
-    brightness_ = brightness;
+    if (brightness != brightness_) {
+      brightness_ = brightness;
+      stale_qs_ = 2;
+    }
   }
   
   inline void set_damping(float damping) {
-    damping_ = damping;
+    if (damping != damping_) {
+      damping_ = damping;
+      stale_qs_ = 2;
+    }
   }
   
   inline void set_position(float position) {
@@ -78,7 +93,11 @@ class Resonator {
   }
   
   inline void set_resolution(size_t resolution) {
-    resolution_ = std::min(resolution, kMaxModes);
+    resolution = std::min(resolution, kMaxModes);
+    if (resolution != resolution_) {
+      resolution_ = resolution;
+      stale_frequencies_ = 2;
+    }
   }
   
   inline void set_modulation_frequency(float modulation_frequency) {
@@ -104,6 +123,7 @@ class Resonator {
   
  private:
   size_t ComputeFilters();
+  void ComputeQs();
   
   float frequency_;
   float geometry_;
@@ -120,12 +140,22 @@ class Resonator {
   
   size_t resolution_;
   
-  stmlib::Svf f_[kMaxModes];
+  float partial_frequency_[kMaxModes];
+  float partial_q_[kMaxModes];
+  
+  stmlib::ModalBank<kMaxModes> f_;
   stmlib::Svf f_bow_[kMaxBowedModes];
   stmlib::DelayLine<float, kMaxDelayLineSize> d_bow_[kMaxBowedModes];
   
   size_t clock_divider_;
   
+  // Number of ComputeFilters() calls still needed to bring the frequencies
+  // (and Qs) or only the Qs up to date: the upper modes are refreshed every
+  // other call.
+  int32_t stale_frequencies_;
+  int32_t stale_qs_;
+  size_t num_modes_;
+  
   DISALLOW_COPY_AND_ASSIGN(Resonator);
 };
 
@@ -96,7 +96,7 @@ class String {
   String() { }
   ~String() { }
   
-  void Init(bool enable_dispersion);
+  void Init(bool enable_dispersion, float sample_rate);
   void Process(const float* in, float* out, float* aux, size_t size);
   
   inline void set_frequency(float frequency) {
@@ -154,6 +154,7 @@ class String {
   float aux_sample_[2];
   
   float curved_bridge_;
+  float sr_;
   
   StringDelayLine string_;
   StiffnessDelayLine stretch_;
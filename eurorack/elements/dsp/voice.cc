@@ -38,11 +38,12 @@ namespace elements {
 using namespace std;
 using namespace stmlib;
 
-void Voice::Init() {
+void Voice::Init(float sample_rate) {
+  sr_ = sample_rate;
   envelope_.Init();
-  bow_.Init();
-  blow_.Init();
-  strike_.Init();
+  bow_.Init(sample_rate);
+  blow_.Init(sample_rate);
+  strike_.Init(sample_rate);
   diffuser_.Init(diffuser_buffer_);
   
   ResetResonator();
@@ -65,11 +66,11 @@ void Voice::Init() {
 }
 
 void Voice::ResetResonator() {
-  resonator_.Init();
+  resonator_.Init(sr_);
   for (size_t i = 0; i < kNumStrings; ++i) {
-    string_[i].Init(true);
+    string_[i].Init(true, sr_);
   }
-  dc_blocker_.Init(1.0f - 10.0f / Dsp::getSr());
+  dc_blocker_.Init(1.0f - 10.0f / sr_);
   resonator_.set_resolution(52);  // Runs with 56 extremely tightly.
 }
 
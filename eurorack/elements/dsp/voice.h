@@ -58,7 +58,7 @@ class Voice {
   Voice() { }
   ~Voice() { }
   
-  void Init();
+  void Init(float sample_rate);
   void Process(
       const Patch& patch,
       float frequency,
@@ -122,6 +122,7 @@ class Voice {
   
   ResonatorModel resonator_model_;
   float chord_index_;
+  float sr_;
   
   DISALLOW_COPY_AND_ASSIGN(Voice);
 };
@@ -46,7 +46,8 @@ class AnalogBassDrum {
   AnalogBassDrum() { }
   ~AnalogBassDrum() { }
 
-  void Init() {
+  void Init(float sample_rate) {
+    sample_rate_ = sample_rate;
     pulse_remaining_samples_ = 0;
     fm_pulse_remaining_samples_ = 0;
     pulse_ = 0.0f;
@@ -82,11 +83,11 @@ class AnalogBassDrum {
       float self_fm_amount,
       float* out,
       size_t size) {
-    const int kTriggerPulseDuration = 1.0e-3f * kSampleRate;
-    const int kFMPulseDuration = 6.0e-3f * kSampleRate;
-    const float kPulseDecayTime = 0.2e-3f * kSampleRate;
-    const float kPulseFilterTime = 0.1e-3f * kSampleRate;
-    const float kRetrigPulseDuration = 0.05f * kSampleRate;
+    const int kTriggerPulseDuration = 1.0e-3f * sample_rate_;
+    const int kFMPulseDuration = 6.0e-3f * sample_rate_;
+    const float kPulseDecayTime = 0.2e-3f * sample_rate_;
+    const float kPulseFilterTime = 0.1e-3f * sample_rate_;
+    const float kRetrigPulseDuration = 0.05f * sample_rate_;
     
     const float scale = 0.001f / f0;
     const float q = 1500.0f * stmlib::SemitonesToRatio(decay * 80.0f);
@@ -187,6 +188,8 @@ class AnalogBassDrum {
   // Replace the resonator in "free running" (sustain) mode.
   SineOscillator oscillator_;
   
+  float sample_rate_;
+  
   DISALLOW_COPY_AND_ASSIGN(AnalogBassDrum);
 };
   
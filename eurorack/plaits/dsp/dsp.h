@@ -31,12 +31,10 @@
 
 #include "stmlib/stmlib.h"
 
-extern float kSampleRate;
-extern float a0;
-
 namespace plaits {
   
 //static const float kSampleRate = 48000.0f;
+// The sample rate is now a per-instance setting, see Voice::Init().
 
 // There is no proper PLL for I2S, only a divider on the system clock to derive
 // the bit clock.
@@ -36,7 +36,7 @@
 
 namespace plaits {
 
-inline float NoteToFrequency(float midi_note) {
+inline float NoteToFrequency(float midi_note, float a0) {
   midi_note -= 9.0f;
   CONSTRAIN(midi_note, -128.0f, 127.0f);
   return a0 * 0.25f * stmlib::SemitonesToRatio(midi_note);
@@ -88,7 +88,22 @@ class Engine {
       float* aux,
       size_t size,
       bool* already_enveloped) = 0;
+  
+  // Must be called before Init().
+  void set_sample_rate(float sample_rate) {
+    sample_rate_ = sample_rate;
+    a0_ = (440.0f / 8.0f) / sample_rate;
+  }
+  
   PostProcessingSettings post_processing_settings;
+  
+ protected:
+  inline float NoteToFrequency(float midi_note) const {
+    return plaits::NoteToFrequency(midi_note, a0_);
+  }
+  
+  float sample_rate_;
+  float a0_;
 };
 
 template<int max_size>
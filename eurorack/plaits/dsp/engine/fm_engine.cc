@@ -42,8 +42,8 @@ void FMEngine::Init(BufferAllocator* allocator) {
   modulator_phase_ = 0;
   sub_phase_ = 0;
 
-  previous_carrier_frequency_ = a0;
-  previous_modulator_frequency_ = a0;
+  previous_carrier_frequency_ = a0_;
+  previous_modulator_frequency_ = a0_;
   previous_amount_ = 0.0f;
   previous_feedback_ = 0.0f;
   previous_sample_ = 0.0f;
@@ -34,8 +34,8 @@ namespace plaits {
 using namespace stmlib;
 
 void HiHatEngine::Init(BufferAllocator* allocator) {
-  hi_hat_1_.Init();
-  hi_hat_2_.Init();
+  hi_hat_1_.Init(sample_rate_);
+  hi_hat_2_.Init(sample_rate_);
   temp_buffer_ = allocator->Allocate<float>(kMaxBlockSize * 2);
 }
 
@@ -36,8 +36,8 @@ using namespace std;
 using namespace stmlib;
 
 void SnareDrumEngine::Init(BufferAllocator* allocator) {
-  analog_snare_drum_.Init();
-  synthetic_snare_drum_.Init();
+  analog_snare_drum_.Init(sample_rate_);
+  synthetic_snare_drum_.Init(sample_rate_);
 }
 
 void SnareDrumEngine::Reset() {
@@ -36,13 +36,15 @@ using namespace std;
 using namespace stmlib;
 
 void SpeechEngine::Init(BufferAllocator* allocator) {
-  sam_speech_synth_.Init();
-  naive_speech_synth_.Init();
+  sam_speech_synth_.Init(sample_rate_);
+  naive_speech_synth_.Init(sample_rate_);
   lpc_speech_synth_word_bank_.Init(
       word_banks_,
       LPC_SPEECH_SYNTH_NUM_WORD_BANKS,
       allocator);
-  lpc_speech_synth_controller_.Init(&lpc_speech_synth_word_bank_);
+  lpc_speech_synth_controller_.Init(
+      &lpc_speech_synth_word_bank_,
+      sample_rate_);
   word_bank_quantizer_.Init(LPC_SPEECH_SYNTH_NUM_WORD_BANKS + 1, 0.1f, false);
   
   temp_buffer_[0] = allocator->Allocate<float>(kMaxBlockSize);
@@ -38,7 +38,7 @@ using namespace stmlib;
 void StringEngine::Init(BufferAllocator* allocator) {
   temp_buffer_ = allocator->Allocate<float>(kMaxBlockSize);
   for (int i = 0; i < kNumStrings; ++i) {
-    voice_[i].Init(allocator);
+    voice_[i].Init(allocator, sample_rate_);
     f0_[i] = 0.01f;
   }
   active_string_ = kNumStrings - 1;
@@ -59,11 +59,11 @@ void WavetableEngine::Init(BufferAllocator* allocator) {
   previous_x_ = 0.0f;
   previous_y_ = 0.0f;
   previous_z_ = 0.0f;
-  previous_f0_ = a0;
+  previous_f0_ = a0_;
 
   diff_out_.Init();
   
-  wave_map_ = allocator->Allocate<const int16_t*>(kNumWavesPerBank);
+  wave_map_ = allocator->Allocate<const int16_t*>(kNumBanks * kNumWavesPerBank);
 }
 
 void WavetableEngine::Reset() {
@@ -112,7 +112,7 @@ void ChiptuneEngine::Render(
   if (envelope_shape_ != NO_ENVELOPE) {
     const float shape = fabsf(envelope_shape_);
     const float decay = 1.0f - \
-        2.0f / kSampleRate * SemitonesToRatio(60.0f * shape) * shape;
+        2.0f / sample_rate_ * SemitonesToRatio(60.0f * shape) * shape;
     float aux_envelope_amount = envelope_shape_ * 20.0f;
     CONSTRAIN(aux_envelope_amount, 0.0f, 1.0f);
     
@@ -70,18 +70,17 @@ void FMVoice::LoadPatch(const fm::Patch* patch) {
   lfo_.Set(patch_->modulations);
 }
 
-const int kNumPatchesPerBank = 32;
-
 void SixOpEngine::Init(BufferAllocator* allocator) {
   patch_index_quantizer_.Init(32, 0.005f, false);
 
   algorithms_.Init();
   for (int i = 0; i < kNumSixOpVoices; ++i) {
-    voice_[i].Init(&algorithms_, kSampleRate);      // kCorrectedSampleRate
+    voice_[i].Init(&algorithms_, sample_rate_);      // kCorrectedSampleRate
   }
   temp_buffer_ = allocator->Allocate<float>(kMaxBlockSize * 4);
   acc_buffer_ = allocator->Allocate<float>(kMaxBlockSize * kNumSixOpVoices);
-  patches_ = allocator->Allocate<fm::Patch>(kNumPatchesPerBank);
+  bank_ = allocator->Allocate<fm::Patch>(kNumPatchesPerBank);
+  patches_ = bank_;
   
   active_voice_ = kNumSixOpVoices - 1;
   rendered_voice_ = 0;
@@ -93,8 +92,13 @@ void SixOpEngine::Reset() {
 
 void SixOpEngine::LoadUserData(const uint8_t* user_data) {
   for (int i = 0; i < kNumPatchesPerBank; ++i) {
-    patches_[i].Unpack(user_data + i * fm::Patch::SYX_SIZE);
+    bank_[i].Unpack(user_data + i * fm::Patch::SYX_SIZE);
   }
+  LoadPatches(bank_);
+}
+
+void SixOpEngine::LoadPatches(const fm::Patch* patches) {
+  patches_ = patches;
   for (int i = 0; i < kNumSixOpVoices; ++i) {
     voice_[i].UnloadPatch();
   }
@@ -111,7 +115,7 @@ void SixOpEngine::Render(
   
   if (parameters.trigger & TRIGGER_UNPATCHED) {
     const float t = parameters.morph;
-    voice_[0].mutable_lfo()->Scrub(2.0f * kSampleRate * t);  // kCorrectedSampleRate
+    voice_[0].mutable_lfo()->Scrub(2.0f * sample_rate_ * t);  // kCorrectedSampleRate
 
     for (int i = 0; i < kNumSixOpVoices; ++i) {
       voice_[i].LoadPatch(&patches_[patch_index]);
@@ -40,6 +40,7 @@
 namespace plaits {
 
 const int kNumSixOpVoices = 2;
+const int kNumPatchesPerBank = 32;
 
 class FMVoice {
  public:
@@ -92,6 +93,12 @@ class SixOpEngine : public Engine {
   virtual void Init(stmlib::BufferAllocator* allocator);
   virtual void Reset();
   virtual void LoadUserData(const uint8_t* user_data);
+  
+  // Plays kNumPatchesPerBank patches unpacked beforehand instead of the bank
+  // unpacked by LoadUserData(). They are only read, and can be shared with
+  // other engines.
+  void LoadPatches(const fm::Patch* patches);
+  
   virtual void Render(const EngineParameters& parameters,
       float* out,
       float* aux,
@@ -103,7 +110,8 @@ class SixOpEngine : public Engine {
  private:
   stmlib::HysteresisQuantizer2 patch_index_quantizer_;
   fm::Algorithms<6> algorithms_;
-  fm::Patch* patches_;
+  fm::Patch* bank_;
+  const fm::Patch* patches_;
   FMVoice voice_[kNumSixOpVoices];
   float* temp_buffer_;
   float* acc_buffer_;
@@ -51,9 +51,13 @@ void Resonator::Init(float position, int resolution) {
     mode_amplitude_[i] = amplitudes.Next() * 0.25f;
   }
   
-  for (int i = 0; i < kMaxNumModes / kModeBatchSize; ++i) {
-    mode_filters_[i].Init();
-  }
+  mode_filters_.Init();
+  
+  // Not a valid frequency: forces the first Process() to compute everything.
+  f0_ = -1.0f;
+  structure_ = 0.0f;
+  brightness_ = 0.0f;
+  damping_ = 0.0f;
 }
 
 inline float NthHarmonicCompensation(int n, float stiffness) {
@@ -77,60 +81,71 @@ void Resonator::Process(
     const float* in,
     float* out,
     size_t size) {
-  float stiffness = Interpolate(lut_stiffness, structure, 64.0f);
-  f0 *= NthHarmonicCompensation(3, stiffness);
-  
-  float harmonic = f0;
-  float stretch_factor = 1.0f;
-  float q_sqrt = SemitonesToRatio(damping * 79.7f);
-  float q = 500.0f * q_sqrt * q_sqrt;
-  brightness *= 1.0f - structure * 0.3f;
-  brightness *= 1.0f - damping * 0.3f;
-  float q_loss = brightness * (2.0f - brightness) * 0.85f + 0.15f;
+  // Only whole batches of modes are rendered.
+  const int num_modes = resolution_ - resolution_ % kModeBatchSize;
   
-  float mode_q[kModeBatchSize];
-  float mode_f[kModeBatchSize];
-  float mode_a[kModeBatchSize];
-  int batch_counter = 0;
-  
-  ResonatorSvf<kModeBatchSize>* batch_processor = &mode_filters_[0];
-  
-  
-  for (int i = 0; i < resolution_; ++i) {
-    float mode_frequency = harmonic * stretch_factor;
-    if (mode_frequency >= 0.499f) {
-      mode_frequency = 0.499f;
+  bool frequencies_changed = f0 != f0_ || structure != structure_;
+  if (frequencies_changed) {
+    f0_ = f0;
+    structure_ = structure;
+    
+    float stiffness = Interpolate(lut_stiffness, structure, 64.0f);
+    f0 *= NthHarmonicCompensation(3, stiffness);
+    
+    float harmonic = f0;
+    float stretch_factor = 1.0f;
+    for (int i = 0; i < num_modes; ++i) {
+      float mode_frequency = harmonic * stretch_factor;
+      if (mode_frequency >= 0.499f) {
+        mode_frequency = 0.499f;
+      }
+      const float mode_attenuation = 1.0f - mode_frequency * 2.0f;
+      
+      mode_f_[i] = mode_frequency;
+      mode_a_[i] = mode_amplitude_[i] * mode_attenuation;
+      
+      stretch_factor += stiffness;
+      if (stiffness < 0.0f) {
+        // Make sure that the partials do not fold back into negative
+        // frequencies.
+        stiffness *= 0.93f;
+      } else {
+        // This helps adding a few extra partials in the highest frequencies.
+        stiffness *= 0.98f;
+      }
+      harmonic += f0;
     }
-    const float mode_attenuation = 1.0f - mode_frequency * 2.0f;
+  }
+  
+  if (frequencies_changed || brightness != brightness_ || damping != damping_) {
+    brightness_ = brightness;
+    damping_ = damping;
     
-    mode_f[batch_counter] = mode_frequency;
-    mode_q[batch_counter] = 1.0f + mode_frequency * q;
-    mode_a[batch_counter] = mode_amplitude_[i] * mode_attenuation;
-    ++batch_counter;
+    float q_sqrt = SemitonesToRatio(damping * 79.7f);
+    float q = 500.0f * q_sqrt * q_sqrt;
+    brightness *= 1.0f - structure * 0.3f;
+    brightness *= 1.0f - damping * 0.3f;
+    float q_loss = brightness * (2.0f - brightness) * 0.85f + 0.15f;
     
-    if (batch_counter == kModeBatchSize) {
-      batch_counter = 0;
-      batch_processor->Process<FILTER_MODE_BAND_PASS, true>(
-          mode_f,
-          mode_q,
-          mode_a,
-          in,
-          out,
-          size);
-      ++batch_processor;
+    float mode_q[kMaxNumModes];
+    for (int i = 0; i < num_modes; ++i) {
+      mode_q[i] = 1.0f + mode_f_[i] * q;
+      q *= q_loss;
     }
     
-    stretch_factor += stiffness;
-    if (stiffness < 0.0f) {
-      // Make sure that the partials do not fold back into negative frequencies.
-      stiffness *= 0.93f;
+    if (frequencies_changed) {
+      mode_filters_.set_f_q<FREQUENCY_FAST>(mode_f_, mode_q, num_modes);
     } else {
-      // This helps adding a few extra partials in the highest frequencies.
-      stiffness *= 0.98f;
+      mode_filters_.set_q(mode_q, num_modes);
     }
-    harmonic += f0;
-    q *= q_loss;
   }
+  
+  mode_filters_.Process<FILTER_MODE_BAND_PASS, true>(
+      mode_a_,
+      num_modes,
+      in,
+      out,
+      size);
 }
 
 }  // namespace plaits
@@ -30,6 +30,7 @@
 #define PLAITS_DSP_PHYSICAL_MODELLING_RESONATOR_H_
 
 #include "stmlib/dsp/filter.h"
+#include "stmlib/dsp/modal_bank.h"
 
 namespace plaits {
 
@@ -123,8 +124,17 @@ class Resonator {
  private:
   int resolution_;
   
+  // Parameters of the last call. The mode frequencies and amplitudes are
+  // only recomputed when f0 or structure change, the Qs when any of them do.
+  float f0_;
+  float structure_;
+  float brightness_;
+  float damping_;
+  
   float mode_amplitude_[kMaxNumModes];
-  ResonatorSvf<kModeBatchSize> mode_filters_[kMaxNumModes / kModeBatchSize];
+  float mode_f_[kMaxNumModes];
+  float mode_a_[kMaxNumModes];
+  stmlib::ModalBank<kMaxNumModes> mode_filters_;
   
   DISALLOW_COPY_AND_ASSIGN(Resonator);
 };
@@ -52,7 +52,7 @@ class String {
   String() { }
   ~String() { }
   
-  void Init(stmlib::BufferAllocator* allocator);
+  void Init(stmlib::BufferAllocator* allocator, float sample_rate);
   void Reset();
   void Process(
       float f0,
@@ -89,6 +89,8 @@ class String {
   float src_phase_;
   float out_sample_[2];
 
+  float sample_rate_;
+  
   DISALLOW_COPY_AND_ASSIGN(String);
 };
 
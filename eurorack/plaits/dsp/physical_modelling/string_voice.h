@@ -41,7 +41,7 @@ class StringVoice {
   StringVoice() { }
   ~StringVoice() { }
   
-  void Init(stmlib::BufferAllocator* allocator);
+  void Init(stmlib::BufferAllocator* allocator, float sample_rate);
   void Reset();
   void Render(
       bool sustain,
@@ -204,7 +204,10 @@ bool LPCSpeechSynthWordBank::Load(int bank) {
   return true;
 }
 
-void LPCSpeechSynthController::Init(LPCSpeechSynthWordBank* word_bank) {
+void LPCSpeechSynthController::Init(
+    LPCSpeechSynthWordBank* word_bank,
+    float sample_rate) {
+  sample_rate_ = sample_rate;
   word_bank_ = word_bank;
   
   clock_phase_ = 0.0f;
@@ -238,7 +241,7 @@ void LPCSpeechSynthController::Render(
   
   // All utterances have been normalized for an average f0 of 100 Hz.
   const float pitch_shift = frequency / \
-      (rate_ratio * kLPCSpeechSynthDefaultF0 / kSampleRate);   //kCorrectedSampleRate -- vb
+      (rate_ratio * kLPCSpeechSynthDefaultF0 / sample_rate_);   //kCorrectedSampleRate -- vb
   const float time_stretch = SemitonesToRatio(-speed * 24.0f +
         (formant_shift < 0.4f ? (formant_shift - 0.4f) * -45.0f
             : (formant_shift > 0.6f ? (formant_shift - 0.6f) * -45.0f : 0.0f)));
@@ -284,7 +287,7 @@ void LPCSpeechSynthController::Render(
   } else {
     if (remaining_frame_samples_ == 0) {
       synth_.PlayFrame(frames, float(playback_frame_), false);
-      remaining_frame_samples_ = kSampleRate / kLPCSpeechSynthFPS * \
+      remaining_frame_samples_ = sample_rate_ / kLPCSpeechSynthFPS * \
           time_stretch;
       ++playback_frame_;
       if (playback_frame_ >= last_playback_frame_) {
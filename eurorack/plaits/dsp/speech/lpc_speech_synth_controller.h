@@ -158,7 +158,7 @@ class LPCSpeechSynthController {
   LPCSpeechSynthController() { }
   ~LPCSpeechSynthController() { }
   
-  void Init(LPCSpeechSynthWordBank* word_bank);
+  void Init(LPCSpeechSynthWordBank* word_bank, float sample_rate);
   
   void Render(
       bool free_running,
@@ -189,6 +189,8 @@ class LPCSpeechSynthController {
   
   static const LPCSpeechSynth::Frame phonemes_[kLPCSpeechSynthNumPhonemes];
   
+  float sample_rate_;
+  
   DISALLOW_COPY_AND_ASSIGN(LPCSpeechSynthController);
 };
 
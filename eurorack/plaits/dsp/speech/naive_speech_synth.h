@@ -46,7 +46,7 @@ class NaiveSpeechSynth {
   NaiveSpeechSynth() { }
   ~NaiveSpeechSynth() { }
 
-  void Init();
+  void Init(float sample_rate);
   
   void Render(
       bool click,
@@ -77,6 +77,9 @@ class NaiveSpeechSynth {
 
   static const Phoneme phonemes_[kNaiveSpeechNumPhonemes][kNaiveSpeechNumRegisters];
   
+  float sample_rate_;
+  float a0_;
+  
   DISALLOW_COPY_AND_ASSIGN(NaiveSpeechSynth);
 };
   
@@ -43,7 +43,7 @@ class SAMSpeechSynth {
   SAMSpeechSynth() { }
   ~SAMSpeechSynth() { }
 
-  void Init();
+  void Init(float sample_rate);
   
   void Render(
       bool consonant,
@@ -82,6 +82,8 @@ class SAMSpeechSynth {
   static const Phoneme phonemes_[kSAMNumPhonemes + 1];
   static const float formant_amplitude_lut[16];
   
+  float sample_rate_;
+  
   DISALLOW_COPY_AND_ASSIGN(SAMSpeechSynth);
 };
   
@@ -34,7 +34,9 @@ namespace plaits {
 using namespace std;
 using namespace stmlib;
 
-void Voice::Init(BufferAllocator* allocator) {
+void Voice::Init(BufferAllocator* allocator, float sample_rate) {
+  sample_rate_ = sample_rate;
+  a0_ = (440.0f / 8.0f) / sample_rate;
   engines_.Init();
   
   engines_.RegisterInstance(&virtual_analog_engine_, false, 0.8f, 0.8f);
@@ -65,14 +67,39 @@ void Voice::Init(BufferAllocator* allocator) {
     engines_.RegisterInstance(&chiptune_engine_, false, 0.5f, 0.5f);
   
   for (int i = 0; i < engines_.size(); ++i) {
-    // All engines will share the same RAM space.
-    allocator->Free();
-    engines_.get(i)->Init(allocator);
+    engines_.get(i)->set_sample_rate(sample_rate);
   }
   
+  allocator_ = allocator;
+  
+  Reset();
+}
+
+size_t Voice::InitEngine(int index) {
+  Engine* e = engines_.get(index);
+  
+  // All engines will share the same RAM space.
+  allocator_->Free();
+  size_t free = allocator_->free();
+  e->Init(allocator_);
+  
+  // The 6-op engine is registered once per bank.
+  for (int i = 0; i < engines_.size(); ++i) {
+    if (engines_.get(i) == e) {
+      initialized_engines_ |= 1 << i;
+    }
+  }
+  return free - allocator_->free();
+}
+
+void Voice::Reset() {
+  // Engines are initialized when they are first selected, see Render(): a
+  // voice which is reset doesn't carry over what its engines played before.
+  initialized_engines_ = 0;
   engine_quantizer_.Init(engines_.size(), 0.05f, true);
   previous_engine_index_ = -1;
   reload_user_data_ = false;
+  fm_patches_ = NULL;
   engine_cv_ = 0.0f;
   
   out_post_processor_.Init();
@@ -132,12 +159,19 @@ void Voice::Render(
   Engine* e = engines_.get(engine_index);
   
   if (engine_index != previous_engine_index_ || reload_user_data_) {
+    if (!(initialized_engines_ & (1 << engine_index))) {
+      InitEngine(engine_index);
+    }
 //    UserData user_data;
+    if (fm_patches_ && is_six_op_engine(engine_index)) {
+      six_op_engine_.LoadPatches(fm_patches_);
+    } else {
       const uint8_t* data = NULL; //user_data.ptr(engine_index);
-      if (!data && engine_index >= 18 && engine_index <= 20) { // vb: these are the three 6-op FM engines
+      if (!data && is_six_op_engine(engine_index)) { // vb: these are the three 6-op FM engines
           data = fm_patches_table[engine_index - 2 - 16];  // vb: repositioned the new batch of engines to the end of the pile
+      }
+      e->LoadUserData(data);
     }
-    e->LoadUserData(data);
     e->Reset();
 
     out_post_processor_.Reset();
@@ -158,7 +192,7 @@ void Voice::Render(
     p.trigger = TRIGGER_UNPATCHED;
   }
   
-  const float short_decay = (200.0f * kBlockSize) / kSampleRate *
+  const float short_decay = (200.0f * kBlockSize) / sample_rate_ *
       SemitonesToRatio(-96.0f * patch.decay);
 
   decay_envelope_.Process(short_decay * 2.0f);
@@ -239,13 +273,13 @@ void Voice::Render(
   // Compute LPG parameters.
   if (!lpg_bypass) {
     const float hf = patch.lpg_colour;
-    const float decay_tail = (20.0f * kBlockSize) / kSampleRate *
+    const float decay_tail = (20.0f * kBlockSize) / sample_rate_ *
         SemitonesToRatio(-72.0f * patch.decay + 12.0f * hf) - short_decay;
     
     if (modulations.level_patched) {
       lpg_envelope_.ProcessLP(compressed_level, short_decay, decay_tail, hf);
     } else {
-      const float attack = NoteToFrequency(p.note) * float(kBlockSize) * 2.0f;
+      const float attack = NoteToFrequency(p.note, a0_) * float(kBlockSize) * 2.0f;
       lpg_envelope_.ProcessPing(attack, short_decay, decay_tail, hf);
     }
   } else {
@@ -67,6 +67,7 @@
 namespace plaits {
 
 const int kMaxEngines = 24;
+STATIC_ASSERT(kMaxEngines <= 32, one_bit_per_engine);
 const int kMaxTriggerDelay = 8;
 const int kTriggerDelay = 5;
 
@@ -195,10 +196,34 @@ class Voice {
     short aux;
   };
   
-  void Init(stmlib::BufferAllocator* allocator);
+  // The engines take their working memory from the allocator, which must
+  // outlive the voice. They share it, and are only initialized (and given
+  // their share of it) the first time they are selected.
+  void Init(stmlib::BufferAllocator* allocator, float sample_rate);
+  
+  // Initializes an engine right away, and returns the number of bytes of
+  // memory it has taken from the allocator.
+  size_t InitEngine(int index);
+  
+  // Brings an initialized voice back to its power-on state. The engines are
+  // initialized again, when they are next selected.
+  void Reset();
   void ReloadUserData() {
     reload_user_data_ = true;
   }
+  
+  // Patches played by the six-op engines instead of their built-in banks:
+  // kNumPatchesPerBank patches unpacked beforehand, only read by the voice.
+  // They must stay valid until the voice has rendered a block with other
+  // ones. NULL goes back to the built-in banks.
+  void set_fm_patches(const fm::Patch* patches) {
+    if (patches != fm_patches_) {
+      fm_patches_ = patches;
+      if (is_six_op_engine(previous_engine_index_)) {
+        reload_user_data_ = true;
+      }
+    }
+  }
   void Render(
       const Patch& patch,
       const Modulations& modulations,
@@ -211,6 +236,11 @@ class Voice {
  private:
   void ComputeDecayParameters(const Patch& settings);
   
+  // the three banks of the 6-op engine come after the original engines
+  static inline bool is_six_op_engine(int index) {
+    return index >= 18 && index <= 20;
+  }
+  
   inline float ApplyModulations(
       float base_value,
       float modulation_amount,
@@ -262,6 +292,7 @@ class Voice {
   stmlib::HysteresisQuantizer2 engine_quantizer_;
   
   bool reload_user_data_;
+  const fm::Patch* fm_patches_;
   int previous_engine_index_;
   float engine_cv_;
   
@@ -278,6 +309,11 @@ class Voice {
   ChannelPostProcessor aux_post_processor_;
   
   EngineRegistry<kMaxEngines> engines_;
+  stmlib::BufferAllocator* allocator_;
+  uint32_t initialized_engines_;
+  
+  float sample_rate_;
+  float a0_;
   
     // vb, // we don't use these anymore
 //  float out_buffer_[kMaxBlockSize];
@@ -42,21 +42,6 @@ namespace rings {
 
     const size_t kMaxBlockSize = 32;     //24;
     
-    // add some code to make SR settable
-    class Dsp {
-        private:
-        static float sr;
-        static float a3;
-        
-        public:
-        static float getSr() {return sr;}
-        static float getA3() {return a3;}
-        static void setSr(float newsr) {
-            sr = newsr;
-            a3 = 440.0f / sr;
-        }
-    };
-
 }  // namespace rings
 
 #endif  // RINGS_DSP_DSP_H_
@@ -40,8 +40,8 @@ namespace rings {
 
 using namespace stmlib;
 
-void FMVoice::Init() {
-    sr_ = Dsp::getSr();
+void FMVoice::Init(float sample_rate) {
+    sr_ = sample_rate;
   set_frequency(220.0f / sr_);
   set_ratio(0.5f);
   set_brightness(0.5f);
@@ -49,7 +49,7 @@ class FMVoice {
   FMVoice() { }
   ~FMVoice() { }
   
-  void Init();
+  void Init(float sample_rate);
   void Process(
       const float* in,
       float* out,
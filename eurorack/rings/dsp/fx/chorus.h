@@ -43,7 +43,7 @@ class Chorus {
   Chorus() { }
   ~Chorus() { }
   
-  void Init(uint16_t* buffer) {
+  void Init(FxBufferType* buffer) {
     engine_.Init(buffer);
     phase_1_ = 0;
     phase_2_ = 0;
@@ -102,7 +102,7 @@ class Chorus {
   }
   
  private:
-  typedef FxEngine<2048, FORMAT_16_BIT> E;
+  typedef FxEngine<2048, kFxBufferFormat> E;
   E engine_;
   
   float amount_;
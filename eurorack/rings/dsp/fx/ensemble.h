@@ -43,7 +43,7 @@ class Ensemble {
   Ensemble() { }
   ~Ensemble() { }
   
-  void Init(uint16_t* buffer) {
+  void Init(FxBufferType* buffer) {
     engine_.Init(buffer);
     phase_1_ = 0;
     phase_2_ = 0;
@@ -117,7 +117,7 @@ class Ensemble {
   }
   
  private:
-  typedef FxEngine<4096, FORMAT_16_BIT> E;
+  typedef FxEngine<4096, kFxBufferFormat> E;
   E engine_;
   
   float amount_;
@@ -95,6 +95,16 @@ struct DataType<FORMAT_32_BIT> {
   }
 };
 
+// Format of the delay memory of the reverb (and of the chorus and ensemble
+// sharing it).
+#ifdef RINGS_FX_FLOAT_BUFFER
+const Format kFxBufferFormat = FORMAT_32_BIT;
+#else
+const Format kFxBufferFormat = FORMAT_16_BIT;
+#endif
+
+typedef DataType<kFxBufferFormat>::T FxBufferType;
+
 template<
     size_t size,
     Format format = FORMAT_12_BIT>
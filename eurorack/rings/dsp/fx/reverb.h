@@ -40,7 +40,7 @@ class Reverb {
   Reverb() { }
   ~Reverb() { }
   
-  void Init(uint16_t* buffer) {
+  void Init(FxBufferType* buffer) {
     engine_.Init(buffer);
     engine_.SetLFOFrequency(LFO_1, 0.5f / 48000.0f);
     engine_.SetLFOFrequency(LFO_2, 0.3f / 48000.0f);
@@ -164,7 +164,7 @@ class Reverb {
   }
   
  private:
-  typedef FxEngine<32768, FORMAT_16_BIT> E;
+  typedef FxEngine<32768, kFxBufferFormat> E;
   E engine_;
   
   float amount_;
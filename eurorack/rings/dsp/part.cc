@@ -38,10 +38,10 @@ namespace rings {
 using namespace std;
 using namespace stmlib;
 
-void Part::Init(uint16_t* reverb_buffer) {
+void Part::Init(FxBufferType* reverb_buffer, float sample_rate) {
     //vb
-    sr_ = Dsp::getSr();
-    a3_ = Dsp::getA3();
+    sr_ = sample_rate;
+    a3_ = 440.0f / sample_rate;
     
   active_voice_ = 0;
   
@@ -57,7 +57,7 @@ void Part::Init(uint16_t* reverb_buffer) {
     excitation_filter_[i].Init();
     plucker_[i].Init();
     dc_blocker_[i].Init(1.0f - 10.0f / sr_);
-      resonator_[i].Init();     // vb, init resonators
+      resonator_[i].Init(sr_);     // vb, init resonators
   }
   
   reverb_.Init(reverb_buffer);
@@ -81,7 +81,7 @@ void Part::ConfigureResonators() {
       {
         int32_t resolution = 64 / polyphony_ - 4;
         for (int32_t i = 0; i < polyphony_; ++i) {
-          resonator_[i].Init();
+          resonator_[i].Init(sr_);
           resonator_[i].set_resolution(resolution);
         }
       }
@@ -98,7 +98,7 @@ void Part::ConfigureResonators() {
         for (int32_t i = 0; i < kNumStrings; ++i) {
           bool has_dispersion = model_ == RESONATOR_MODEL_STRING || \
               model_ == RESONATOR_MODEL_STRING_AND_REVERB;
-          string_[i].Init(has_dispersion);
+          string_[i].Init(has_dispersion, sr_);
 
           float f_lfo = float(kMaxBlockSize) / sr_;
           f_lfo *= lfo_frequencies[i];
@@ -113,7 +113,7 @@ void Part::ConfigureResonators() {
     case RESONATOR_MODEL_FM_VOICE:
       {
         for (int32_t i = 0; i < polyphony_; ++i) {
-          fm_voice_[i].Init();
+          fm_voice_[i].Init(sr_);
         }
       }
       break;
@@ -68,7 +68,7 @@ class Part {
   Part() { }
   ~Part() { }
   
-  void Init(uint16_t* reverb_buffer);
+  void Init(FxBufferType* reverb_buffer, float sample_rate);
   
   void Process(
       const PerformanceState& performance_state,
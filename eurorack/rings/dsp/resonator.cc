@@ -39,12 +39,10 @@ namespace rings {
 using namespace std;
 using namespace stmlib;
 
-void Resonator::Init() {
-  for (int32_t i = 0; i < kMaxModes; ++i) {
-    f_[i].Init();
-  }
+void Resonator::Init(float sample_rate) {
+  f_.Init();
 
-    set_frequency(220.0f / Dsp::getSr());
+    set_frequency(220.0f / sample_rate);
   set_structure(0.25f);
   set_brightness(0.5f);
   set_damping(0.3f);
@@ -52,12 +50,45 @@ void Resonator::Init() {
   set_resolution(kMaxModes);
     
     previous_position_ = 0.f;       // vb, init previous_position_
+  frequencies_dirty_ = true;
+  qs_dirty_ = true;
+  num_modes_ = 0;
 }
 
 int32_t Resonator::ComputeFilters() {
-  float stiffness = Interpolate(lut_stiffness, structure_, 256.0f);
-  float harmonic = frequency_;
-  float stretch_factor = 1.0f; 
+  // The partial frequencies depend on frequency, structure and resolution,
+  // their Qs on all the parameters: nothing to do when none of them changed,
+  // and only the Qs to update when brightness or damping did.
+  if (!frequencies_dirty_ && !qs_dirty_) {
+    return num_modes_;
+  }
+  int32_t num_filters = min(kMaxModes, resolution_);
+  if (frequencies_dirty_) {
+    float stiffness = Interpolate(lut_stiffness, structure_, 256.0f);
+    float harmonic = frequency_;
+    float stretch_factor = 1.0f; 
+    num_modes_ = 0;
+    for (int32_t i = 0; i < num_filters; ++i) {
+      float partial_frequency = harmonic * stretch_factor;
+      if (partial_frequency >= 0.49f) {
+        partial_frequency = 0.49f;
+      } else {
+        num_modes_ = i + 1;
+      }
+      partial_frequencies_[i] = partial_frequency;
+      stretch_factor += stiffness;
+      if (stiffness < 0.0f) {
+        // Make sure that the partials do not fold back into negative
+        // frequencies.
+        stiffness *= 0.93f;
+      } else {
+        // This helps adding a few extra partials in the highest frequencies.
+        stiffness *= 0.98f;
+      }
+      harmonic += frequency_;
+    }
+  }
+  
   float q = 500.0f * Interpolate(
       lut_4_decades,
       damping_,
@@ -71,36 +102,35 @@ int32_t Resonator::ComputeFilters() {
   float brightness = brightness_ * (1.0f - 0.2f * brightness_attenuation);
   float q_loss = brightness * (2.0f - brightness) * 0.85f + 0.15f;
   float q_loss_damping_rate = structure_ * (2.0f - structure_) * 0.1f;
-  int32_t num_modes = 0;
-  for (int32_t i = 0; i < min(kMaxModes, resolution_); ++i) {
-    float partial_frequency = harmonic * stretch_factor;
-    if (partial_frequency >= 0.49f) {
-      partial_frequency = 0.49f;
-    } else {
-      num_modes = i + 1;
-    }
-    f_[i].set_f_q<FREQUENCY_FAST>(
-        partial_frequency,
-        1.0f + partial_frequency * q);
-    stretch_factor += stiffness;
-    if (stiffness < 0.0f) {
-      // Make sure that the partials do not fold back into negative frequencies.
-      stiffness *= 0.93f;
-    } else {
-      // This helps adding a few extra partials in the highest frequencies.
-      stiffness *= 0.98f;
-    }
+  float partial_qs[kMaxModes];
+  for (int32_t i = 0; i < num_filters; ++i) {
+    partial_qs[i] = 1.0f + partial_frequencies_[i] * q;
     // This prevents the highest partials from decaying too fast.
     q_loss += q_loss_damping_rate * (1.0f - q_loss);
-    harmonic += frequency_;
     q *= q_loss;
   }
+  if (frequencies_dirty_) {
+    f_.set_f_q<FREQUENCY_FAST>(partial_frequencies_, partial_qs, num_filters);
+  } else {
+    f_.set_q(partial_qs, num_filters);
+  }
+  frequencies_dirty_ = false;
+  qs_dirty_ = false;
   
-  return num_modes;
+  return num_modes_;
 }
 
 void Resonator::Process(const float* in, float* out, float* aux, size_t size) {
   int32_t num_modes = ComputeFilters();
+  // Modes are summed in pairs (odd ones to out, even ones to aux).
+  num_modes += num_modes & 1;
+  
+  // The pickup amplitudes of the modes, split between the two outputs. The
+  // other half of each array stays 0.
+  float odd_amplitudes[kMaxModes];
+  float even_amplitudes[kMaxModes];
+  fill(&odd_amplitudes[0], &odd_amplitudes[kMaxModes], 0.0f);
+  fill(&even_amplitudes[0], &even_amplitudes[kMaxModes], 0.0f);
   
   ParameterInterpolator position(&previous_position_, position_, size);
   while (size--) {
@@ -108,15 +138,18 @@ void Resonator::Process(const float* in, float* out, float* aux, size_t size) {
     amplitudes.Init<COSINE_OSCILLATOR_APPROXIMATE>(position.Next());
     
     float input = *in++ * 0.125f;
-    float odd = 0.0f;
-    float even = 0.0f;
     amplitudes.Start();
-    for (int32_t i = 0; i < num_modes;) {
-      odd += amplitudes.Next() * f_[i++].Process<FILTER_MODE_BAND_PASS>(input);
-      even += amplitudes.Next() * f_[i++].Process<FILTER_MODE_BAND_PASS>(input);
+    for (int32_t i = 0; i < num_modes; i += 2) {
+      odd_amplitudes[i] = amplitudes.Next();
+      even_amplitudes[i + 1] = amplitudes.Next();
     }
-    *out++ = odd;
-    *aux++ = even;
+    f_.Process<FILTER_MODE_BAND_PASS>(
+        input,
+        odd_amplitudes,
+        even_amplitudes,
+        num_modes,
+        out++,
+        aux++);
   }
 }
 
@@ -36,6 +36,7 @@
 #include "rings/dsp/dsp.h"
 #include "stmlib/dsp/filter.h"
 #include "stmlib/dsp/delay_line.h"
+#include "stmlib/dsp/modal_bank.h"
 
 namespace rings {
 
@@ -46,27 +47,41 @@ class Resonator {
   Resonator() { }
   ~Resonator() { }
   
-  void Init();
+  void Init(float sample_rate);
   void Process(
       const float* in,
       float* out,
       float* aux,
       size_t size);
   
+  // The filter coefficients are only recomputed when one of the parameters
+  // below actually changes, see ComputeFilters().
   inline void set_frequency(float frequency) {
-    frequency_ = frequency;
+    if (frequency != frequency_) {
+      frequency_ = frequency;
+      frequencies_dirty_ = true;
+    }
   }
   
   inline void set_structure(float structure) {
-    structure_ = structure;
+    if (structure != structure_) {
+      structure_ = structure;
+      frequencies_dirty_ = true;
+    }
   }
   
   inline void set_brightness(float brightness) {
-    brightness_ = brightness;
+    if (brightness != brightness_) {
+      brightness_ = brightness;
+      qs_dirty_ = true;
+    }
   }
   
   inline void set_damping(float damping) {
-    damping_ = damping;
+    if (damping != damping_) {
+      damping_ = damping;
+      qs_dirty_ = true;
+    }
   }
   
   inline void set_position(float position) {
@@ -75,7 +90,11 @@ class Resonator {
   
   inline void set_resolution(int32_t resolution) {
     resolution -= resolution & 1; // Must be even!
-    resolution_ = std::min(resolution, kMaxModes);
+    resolution = std::min(resolution, kMaxModes);
+    if (resolution != resolution_) {
+      resolution_ = resolution;
+      frequencies_dirty_ = true;
+    }
   }
   
  private:
@@ -89,7 +108,13 @@ class Resonator {
   
   int32_t resolution_;
   
-  stmlib::Svf f_[kMaxModes];
+  // Frequencies (and Qs) or only Qs to recompute in the next Process().
+  bool frequencies_dirty_;
+  bool qs_dirty_;
+  int32_t num_modes_;
+  float partial_frequencies_[kMaxModes];
+  
+  stmlib::ModalBank<kMaxModes> f_;
   
   DISALLOW_COPY_AND_ASSIGN(Resonator);
 };
@@ -42,8 +42,8 @@ namespace rings {
 using namespace std;
 using namespace stmlib;
 
-void String::Init(bool enable_dispersion) {
-    sr_ = Dsp::getSr();
+void String::Init(bool enable_dispersion, float sample_rate) {
+    sr_ = sample_rate;
   enable_dispersion_ = enable_dispersion;
   
   string_.Init();
@@ -35,9 +35,9 @@ namespace rings {
 using namespace std;
 using namespace stmlib;
 
-void StringSynthPart::Init(uint16_t* reverb_buffer) {
-    sr_ = Dsp::getSr();     // vb
-    a3_ = Dsp::getA3();     // vb
+void StringSynthPart::Init(FxBufferType* reverb_buffer, float sample_rate) {
+    sr_ = sample_rate;              // vb
+    a3_ = 440.0f / sample_rate;     // vb
   active_group_ = 0;
   acquisition_delay_ = 0;
   
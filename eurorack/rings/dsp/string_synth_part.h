@@ -74,7 +74,7 @@ class StringSynthPart {
   StringSynthPart() { }
   ~StringSynthPart() { }
   
-  void Init(uint16_t* reverb_buffer);
+  void Init(FxBufferType* reverb_buffer, float sample_rate);
   
   void Process(
       const PerformanceState& performance_state,
@@ -41,11 +41,12 @@ class Strummer {
   Strummer() { }
   ~Strummer() { }
   
-  void Init(float ioi, float sr) {
+  void Init(float ioi, float sample_rate) {
+    float sr = sample_rate / kMaxBlockSize;
     onset_detector_.Init(
-        8.0f / Dsp::getSr(),
-        160.0f /  Dsp::getSr(),
-        1600.0f /  Dsp::getSr(),
+        8.0f / sample_rate,
+        160.0f / sample_rate,
+        1600.0f / sample_rate,
         sr,
         ioi);
     inhibit_timer_ = static_cast<int32_t>(ioi * sr);
@@ -35,6 +35,7 @@
 
 
 #include "stmlib/stmlib.h"
+#include "stmlib/resources.h"
 
 
 
@@ -49,10 +50,10 @@ extern const uint32_t* lookup_table_uint32_table[];
 extern const float* lookup_table_table[];
 
 extern const float lut_sine[];
-extern const float lut_4_decades[];
-extern const float lut_svf_shift[];
-extern const float lut_stiffness[];
-extern const float lut_fm_frequency_quantizer[];
+using stmlib::lut_4_decades;
+using stmlib::lut_svf_shift;
+using stmlib::lut_stiffness;
+using stmlib::lut_fm_frequency_quantizer;
 #define LUT_SINE 0
 #define LUT_SINE_SIZE 5121
 #define LUT_4_DECADES 1
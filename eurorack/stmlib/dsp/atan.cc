@@ -31,7 +31,7 @@
 namespace stmlib {
 
 /* extern */
-const uint16_t atan_lut[513] = {
+CACHE_ALIGNED const uint16_t atan_lut[513] = {
       0,    20,    40,    61,    81,   101,   122,   142, 
     162,   183,   203,   224,   244,   264,   285,   305, 
     326,   346,   366,   387,   407,   427,   448,   468, 
@@ -0,0 +1,264 @@
+// Copyright 2026 The mi-UGens contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// See http://creativecommons.org/licenses/MIT/ for more information.
+//
+// -----------------------------------------------------------------------------
+//
+// Bank of SVFs all fed by the same input, stored as a structure of arrays so
+// that kSimdWidth modes are updated per instruction. Shared by the modal
+// resonators of Rings, Elements and Plaits.
+//
+// Modes above the requested count are left untouched, exactly like a skipped
+// stmlib::Svf would be: they resume from their old state when the count grows
+// again.
+
+#ifndef STMLIB_DSP_MODAL_BANK_H_
+#define STMLIB_DSP_MODAL_BANK_H_
+
+#include "stmlib/stmlib.h"
+
+#include "stmlib/dsp/filter.h"
+#include "stmlib/dsp/simd.h"
+
+namespace stmlib {
+
+template<size_t max_modes>
+class ModalBank {
+ public:
+  ModalBank() { }
+  ~ModalBank() { }
+
+  void Init() {
+    for (size_t i = 0; i < max_modes; ++i) {
+      set_f_q<FREQUENCY_DIRTY>(i, 0.01f, 100.0f);
+    }
+    Reset();
+  }
+
+  void Reset() {
+    for (size_t i = 0; i < max_modes; ++i) {
+      state_1_[i] = state_2_[i] = 0.0f;
+    }
+  }
+
+  template<FrequencyApproximation approximation>
+  inline void set_f_q(size_t i, float f, float resonance) {
+    set_g_q(i, OnePole::tan<approximation>(f), resonance);
+  }
+
+  inline void set_g_q(size_t i, float g, float resonance) {
+    float r = 1.0f / resonance;
+    g_[i] = g;
+    r_[i] = r;
+    r_plus_g_[i] = r + g;
+    h_[i] = 1.0f / (1.0f + r * g + g * g);
+  }
+
+  // Batched version, setting the first num_modes modes at once.
+  template<FrequencyApproximation approximation>
+  inline void set_f_q(const float* f, const float* resonance, size_t num_modes) {
+    const size_t num_vectors = approximation == FREQUENCY_EXACT
+        ? 0
+        : num_modes & ~(kSimdWidth - 1);
+    const SimdFloat one = SimdFloat::Broadcast(1.0f);
+    for (size_t i = 0; i < num_vectors; i += kSimdWidth) {
+      const SimdFloat g = Tan<approximation>(SimdFloat::Load(&f[i]));
+      const SimdFloat r = one / SimdFloat::Load(&resonance[i]);
+      g.Store(&g_[i]);
+      r.Store(&r_[i]);
+      (r + g).Store(&r_plus_g_[i]);
+      (one / (one + r * g + g * g)).Store(&h_[i]);
+    }
+    for (size_t i = num_vectors; i < num_modes; ++i) {
+      set_f_q<approximation>(i, f[i], resonance[i]);
+    }
+  }
+
+  // Changes the resonance of the first num_modes modes and keeps their
+  // frequencies. Gives the same coefficients as set_f_q() with the frequencies
+  // of the last call.
+  inline void set_q(const float* resonance, size_t num_modes) {
+    const size_t num_vectors = num_modes & ~(kSimdWidth - 1);
+    const SimdFloat one = SimdFloat::Broadcast(1.0f);
+    for (size_t i = 0; i < num_vectors; i += kSimdWidth) {
+      const SimdFloat g = SimdFloat::Load(&g_[i]);
+      const SimdFloat r = one / SimdFloat::Load(&resonance[i]);
+      r.Store(&r_[i]);
+      (r + g).Store(&r_plus_g_[i]);
+      (one / (one + r * g + g * g)).Store(&h_[i]);
+    }
+    for (size_t i = num_vectors; i < num_modes; ++i) {
+      set_g_q(i, g_[i], resonance[i]);
+    }
+  }
+
+  inline float g(size_t i) const { return g_[i]; }
+
+  // Runs one input sample through the first num_modes modes, and returns the
+  // sum of their outputs weighted by amplitude.
+  template<FilterMode mode>
+  inline float Process(float in, const float* amplitude, size_t num_modes) {
+    const size_t num_vectors = num_modes & ~(kSimdWidth - 1);
+    SimdFloat input = SimdFloat::Broadcast(in);
+    SimdFloat sum = SimdFloat::Broadcast(0.0f);
+    for (size_t i = 0; i < num_vectors; i += kSimdWidth) {
+      sum = sum + Tick<mode>(i, input) * SimdFloat::Load(&amplitude[i]);
+    }
+    float s = sum.Sum();
+    for (size_t i = num_vectors; i < num_modes; ++i) {
+      s += Tick<mode>(i, in) * amplitude[i];
+    }
+    return s;
+  }
+
+  // Same for a whole block, with amplitudes held constant.
+  template<FilterMode mode, bool add>
+  inline void Process(
+      const float* amplitude,
+      size_t num_modes,
+      const float* in,
+      float* out,
+      size_t size) {
+    while (size--) {
+      float s = Process<mode>(*in++, amplitude, num_modes);
+      if (add) {
+        *out++ += s;
+      } else {
+        *out++ = s;
+      }
+    }
+  }
+
+  // Runs one input sample through the first num_modes modes, and returns two
+  // differently weighted sums of their outputs.
+  template<FilterMode mode>
+  inline void Process(
+      float in,
+      const float* amplitude_1,
+      const float* amplitude_2,
+      size_t num_modes,
+      float* out_1,
+      float* out_2) {
+    const size_t num_vectors = num_modes & ~(kSimdWidth - 1);
+    SimdFloat input = SimdFloat::Broadcast(in);
+    SimdFloat sum_1 = SimdFloat::Broadcast(0.0f);
+    SimdFloat sum_2 = SimdFloat::Broadcast(0.0f);
+    for (size_t i = 0; i < num_vectors; i += kSimdWidth) {
+      SimdFloat s = Tick<mode>(i, input);
+      sum_1 = sum_1 + s * SimdFloat::Load(&amplitude_1[i]);
+      sum_2 = sum_2 + s * SimdFloat::Load(&amplitude_2[i]);
+    }
+    float s_1 = sum_1.Sum();
+    float s_2 = sum_2.Sum();
+    for (size_t i = num_vectors; i < num_modes; ++i) {
+      float s = Tick<mode>(i, in);
+      s_1 += s * amplitude_1[i];
+      s_2 += s * amplitude_2[i];
+    }
+    *out_1 = s_1;
+    *out_2 = s_2;
+  }
+
+ private:
+  // Same polynomials as OnePole::tan().
+  template<FrequencyApproximation approximation>
+  static inline SimdFloat Tan(SimdFloat f) {
+    const SimdFloat pi = SimdFloat::Broadcast(M_PI_F);
+    if (approximation == FREQUENCY_DIRTY) {
+      const SimdFloat a = SimdFloat::Broadcast(3.736e-01f * M_PI_POW_3);
+      return f * (pi + a * f * f);
+    } else if (approximation == FREQUENCY_FAST) {
+      const SimdFloat a = SimdFloat::Broadcast(3.260e-01f * M_PI_POW_3);
+      const SimdFloat b = SimdFloat::Broadcast(1.823e-01f * M_PI_POW_5);
+      const SimdFloat f2 = f * f;
+      return f * (pi + f2 * (a + b * f2));
+    } else {
+      const SimdFloat a = SimdFloat::Broadcast(3.333314036e-01f * M_PI_POW_3);
+      const SimdFloat b = SimdFloat::Broadcast(1.333923995e-01f * M_PI_POW_5);
+      const SimdFloat c = SimdFloat::Broadcast(5.33740603e-02f * M_PI_POW_7);
+      const SimdFloat d = SimdFloat::Broadcast(2.900525e-03f * M_PI_POW_9);
+      const SimdFloat e = SimdFloat::Broadcast(9.5168091e-03f * M_PI_POW_11);
+      const SimdFloat f2 = f * f;
+      return f * (pi + f2 * (a + f2 * (b + f2 * (c + f2 * (d + f2 * e)))));
+    }
+  }
+
+  template<FilterMode mode>
+  inline SimdFloat Tick(size_t i, SimdFloat in) {
+    const SimdFloat g = SimdFloat::Load(&g_[i]);
+    const SimdFloat state_1 = SimdFloat::Load(&state_1_[i]);
+    const SimdFloat state_2 = SimdFloat::Load(&state_2_[i]);
+    const SimdFloat r_plus_g = SimdFloat::Load(&r_plus_g_[i]);
+    const SimdFloat hp = (in - r_plus_g * state_1 - state_2) *
+        SimdFloat::Load(&h_[i]);
+    const SimdFloat bp = g * hp + state_1;
+    const SimdFloat lp = g * bp + state_2;
+    (g * hp + bp).Store(&state_1_[i]);
+    (g * bp + lp).Store(&state_2_[i]);
+
+    if (mode == FILTER_MODE_LOW_PASS) {
+      return lp;
+    } else if (mode == FILTER_MODE_BAND_PASS) {
+      return bp;
+    } else if (mode == FILTER_MODE_BAND_PASS_NORMALIZED) {
+      return bp * SimdFloat::Load(&r_[i]);
+    } else {
+      return hp;
+    }
+  }
+
+  // Scalar version, for the modes which do not fill a whole vector.
+  template<FilterMode mode>
+  inline float Tick(size_t i, float in) {
+    const float g = g_[i];
+    const float hp = (in - r_plus_g_[i] * state_1_[i] - state_2_[i]) * h_[i];
+    const float bp = g * hp + state_1_[i];
+    const float lp = g * bp + state_2_[i];
+    state_1_[i] = g * hp + bp;
+    state_2_[i] = g * bp + lp;
+
+    if (mode == FILTER_MODE_LOW_PASS) {
+      return lp;
+    } else if (mode == FILTER_MODE_BAND_PASS) {
+      return bp;
+    } else if (mode == FILTER_MODE_BAND_PASS_NORMALIZED) {
+      return bp * r_[i];
+    } else {
+      return hp;
+    }
+  }
+
+  static_assert(max_modes % kSimdWidth == 0,
+      "the number of modes must be a multiple of the vector size");
+
+  float g_[max_modes];
+  float r_[max_modes];
+  float r_plus_g_[max_modes];
+  float h_[max_modes];
+  float state_1_[max_modes];
+  float state_2_[max_modes];
+
+  DISALLOW_COPY_AND_ASSIGN(ModalBank);
+};
+
+}  // namespace stmlib
+
+#endif  // STMLIB_DSP_MODAL_BANK_H_
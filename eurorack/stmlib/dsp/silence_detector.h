@@ -0,0 +1,88 @@
+// Copyright 2026 The mi-UGens contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// See http://creativecommons.org/licenses/MIT/ for more information.
+//
+// -----------------------------------------------------------------------------
+//
+// Tells when a voice can go to sleep: once all its signals have stayed below
+// -120 dB for the hold time. What wakes it up again is up to the caller.
+
+#ifndef STMLIB_DSP_SILENCE_DETECTOR_H_
+#define STMLIB_DSP_SILENCE_DETECTOR_H_
+
+#include "stmlib/stmlib.h"
+
+#include <cmath>
+
+namespace stmlib {
+
+const float kSilenceLevel = 1e-6f;
+
+class SilenceDetector {
+ public:
+  SilenceDetector() { }
+  ~SilenceDetector() { }
+
+  void Init(float sample_rate, float hold_time = 0.5f) {
+    hold_samples_ = static_cast<uint32_t>(hold_time * sample_rate);
+    quiet_samples_ = 0;
+    asleep_ = false;
+  }
+
+  static inline bool IsSilent(const float* in, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+      if (fabsf(in[i]) > kSilenceLevel) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Counts a block of 'size' samples, silent or not. Returns true when the
+  // voice falls asleep.
+  inline bool Process(bool silent, size_t size) {
+    if (!silent) {
+      quiet_samples_ = 0;
+      return false;
+    }
+    quiet_samples_ += size;
+    asleep_ = quiet_samples_ >= hold_samples_;
+    return asleep_;
+  }
+
+  inline void Wake() {
+    asleep_ = false;
+    quiet_samples_ = 0;
+  }
+
+  inline bool asleep() const { return asleep_; }
+
+ private:
+  uint32_t hold_samples_;
+  uint32_t quiet_samples_;
+  bool asleep_;
+
+  DISALLOW_COPY_AND_ASSIGN(SilenceDetector);
+};
+
+}  // namespace stmlib
+
+#endif  // STMLIB_DSP_SILENCE_DETECTOR_H_
@@ -0,0 +1,291 @@
+// Copyright 2026 The mi-UGens contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// See http://creativecommons.org/licenses/MIT/ for more information.
+//
+// -----------------------------------------------------------------------------
+//
+// Minimal wrapper around a vector of floats, mapped to AVX, SSE or to a plain
+// array the compiler is free to auto-vectorize (NEON on arm64...).
+//
+// The instruction set is picked at build time from the compiler flags. Define
+// STMLIB_SIMD_NONE to force the portable fallback.
+//
+// All loads and stores are unaligned: unit memory handed out by scsynth's
+// real-time allocator is not guaranteed to be 32-byte aligned.
+
+#ifndef STMLIB_DSP_SIMD_H_
+#define STMLIB_DSP_SIMD_H_
+
+#include "stmlib/stmlib.h"
+
+#include <cmath>
+
+#if !defined(STMLIB_SIMD_NONE) && defined(__AVX__)
+#define STMLIB_SIMD_AVX
+#include <immintrin.h>
+#elif !defined(STMLIB_SIMD_NONE) && (defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define STMLIB_SIMD_SSE
+#include <emmintrin.h>
+#endif
+
+namespace stmlib {
+
+#if defined(STMLIB_SIMD_AVX)
+
+const size_t kSimdWidth = 8;
+
+class SimdFloat {
+ public:
+  SimdFloat() { }
+  SimdFloat(__m256 v) : v_(v) { }
+
+  static inline SimdFloat Load(const float* p) {
+    return SimdFloat(_mm256_loadu_ps(p));
+  }
+
+  static inline SimdFloat Load(const int32_t* p) {
+    return SimdFloat(_mm256_cvtepi32_ps(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))));
+  }
+
+  static inline SimdFloat Broadcast(float x) {
+    return SimdFloat(_mm256_set1_ps(x));
+  }
+
+  inline void Store(float* p) const {
+    _mm256_storeu_ps(p, v_);
+  }
+
+  inline float Sum() const {
+    __m128 s = _mm_add_ps(
+        _mm256_castps256_ps128(v_),
+        _mm256_extractf128_ps(v_, 1));
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+    return _mm_cvtss_f32(s);
+  }
+
+  inline SimdFloat operator+(SimdFloat b) const {
+    return _mm256_add_ps(v_, b.v_);
+  }
+  inline SimdFloat operator-(SimdFloat b) const {
+    return _mm256_sub_ps(v_, b.v_);
+  }
+  inline SimdFloat operator*(SimdFloat b) const {
+    return _mm256_mul_ps(v_, b.v_);
+  }
+  inline SimdFloat operator/(SimdFloat b) const {
+    return _mm256_div_ps(v_, b.v_);
+  }
+
+  inline SimdFloat Abs() const {
+    return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), v_);
+  }
+
+  static inline SimdFloat Max(SimdFloat a, SimdFloat b) {
+    return _mm256_max_ps(a.v_, b.v_);
+  }
+
+  static inline SimdFloat Min(SimdFloat a, SimdFloat b) {
+    return _mm256_min_ps(a.v_, b.v_);
+  }
+
+  // Picks if_positive in the lanes where x > 0, otherwise in the others.
+  static inline SimdFloat SelectPositive(
+      SimdFloat x, SimdFloat if_positive, SimdFloat otherwise) {
+    __m256 mask = _mm256_cmp_ps(x.v_, _mm256_setzero_ps(), _CMP_GT_OQ);
+    return _mm256_blendv_ps(otherwise.v_, if_positive.v_, mask);
+  }
+
+ private:
+  __m256 v_;
+};
+
+#elif defined(STMLIB_SIMD_SSE)
+
+const size_t kSimdWidth = 4;
+
+class SimdFloat {
+ public:
+  SimdFloat() { }
+  SimdFloat(__m128 v) : v_(v) { }
+
+  static inline SimdFloat Load(const float* p) {
+    return SimdFloat(_mm_loadu_ps(p));
+  }
+
+  static inline SimdFloat Load(const int32_t* p) {
+    return SimdFloat(_mm_cvtepi32_ps(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(p))));
+  }
+
+  static inline SimdFloat Broadcast(float x) {
+    return SimdFloat(_mm_set1_ps(x));
+  }
+
+  inline void Store(float* p) const {
+    _mm_storeu_ps(p, v_);
+  }
+
+  inline float Sum() const {
+    __m128 s = _mm_add_ps(v_, _mm_movehl_ps(v_, v_));
+    s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+    return _mm_cvtss_f32(s);
+  }
+
+  inline SimdFloat operator+(SimdFloat b) const {
+    return _mm_add_ps(v_, b.v_);
+  }
+  inline SimdFloat operator-(SimdFloat b) const {
+    return _mm_sub_ps(v_, b.v_);
+  }
+  inline SimdFloat operator*(SimdFloat b) const {
+    return _mm_mul_ps(v_, b.v_);
+  }
+  inline SimdFloat operator/(SimdFloat b) const {
+    return _mm_div_ps(v_, b.v_);
+  }
+
+  inline SimdFloat Abs() const {
+    return _mm_andnot_ps(_mm_set1_ps(-0.0f), v_);
+  }
+
+  static inline SimdFloat Max(SimdFloat a, SimdFloat b) {
+    return _mm_max_ps(a.v_, b.v_);
+  }
+
+  static inline SimdFloat Min(SimdFloat a, SimdFloat b) {
+    return _mm_min_ps(a.v_, b.v_);
+  }
+
+  static inline SimdFloat SelectPositive(
+      SimdFloat x, SimdFloat if_positive, SimdFloat otherwise) {
+    __m128 mask = _mm_cmpgt_ps(x.v_, _mm_setzero_ps());
+    return _mm_or_ps(
+        _mm_and_ps(mask, if_positive.v_),
+        _mm_andnot_ps(mask, otherwise.v_));
+  }
+
+ private:
+  __m128 v_;
+};
+
+#else
+
+const size_t kSimdWidth = 4;
+
+class SimdFloat {
+ public:
+  SimdFloat() { }
+
+  static inline SimdFloat Load(const float* p) {
+    SimdFloat r;
+    for (size_t i = 0; i < kSimdWidth; ++i) r.v_[i] = p[i];
+    return r;
+  }
+
+  static inline SimdFloat Load(const int32_t* p) {
+    SimdFloat r;
+    for (size_t i = 0; i < kSimdWidth; ++i) r.v_[i] = p[i];
+    return r;
+  }
+
+  static inline SimdFloat Broadcast(float x) {
+    SimdFloat r;
+    for (size_t i = 0; i < kSimdWidth; ++i) r.v_[i] = x;
+    return r;
+  }
+
+  inline void Store(float* p) const {
+    for (size_t i = 0; i < kSimdWidth; ++i) p[i] = v_[i];
+  }
+
+  inline float Sum() const {
+    return (v_[0] + v_[2]) + (v_[1] + v_[3]);
+  }
+
+  inline SimdFloat operator+(SimdFloat b) const {
+    SimdFloat r;
+    for (size_t i = 0; i < kSimdWidth; ++i) r.v_[i] = v_[i] + b.v_[i];
+    return r;
+  }
+  inline SimdFloat operator-(SimdFloat b) const {
+    SimdFloat r;
+    for (size_t i = 0; i < kSimdWidth; ++i) r.v_[i] = v_[i] - b.v_[i];
+    return r;
+  }
+  inline SimdFloat operator*(SimdFloat b) const {
+    SimdFloat r;
+    for (size_t i = 0; i < kSimdWidth; ++i) r.v_[i] = v_[i] * b.v_[i];
+    return r;
+  }
+  inline SimdFloat operator/(SimdFloat b) const {
+    SimdFloat r;
+    for (size_t i = 0; i < kSimdWidth; ++i) r.v_[i] = v_[i] / b.v_[i];
+    return r;
+  }
+
+  inline SimdFloat Abs() const {
+    SimdFloat r;
+    for (size_t i = 0; i < kSimdWidth; ++i) r.v_[i] = fabsf(v_[i]);
+    return r;
+  }
+
+  static inline SimdFloat Max(SimdFloat a, SimdFloat b) {
+    SimdFloat r;
+    for (size_t i = 0; i < kSimdWidth; ++i) {
+      r.v_[i] = a.v_[i] > b.v_[i] ? a.v_[i] : b.v_[i];
+    }
+    return r;
+  }
+
+  static inline SimdFloat Min(SimdFloat a, SimdFloat b) {
+    SimdFloat r;
+    for (size_t i = 0; i < kSimdWidth; ++i) {
+      r.v_[i] = a.v_[i] < b.v_[i] ? a.v_[i] : b.v_[i];
+    }
+    return r;
+  }
+
+  static inline SimdFloat SelectPositive(
+      SimdFloat x, SimdFloat if_positive, SimdFloat otherwise) {
+    SimdFloat r;
+    for (size_t i = 0; i < kSimdWidth; ++i) {
+      r.v_[i] = x.v_[i] > 0.0f ? if_positive.v_[i] : otherwise.v_[i];
+    }
+    return r;
+  }
+
+ private:
+  float v_[kSimdWidth];
+};
+
+#endif
+
+// Rounds a number of items up to a whole number of vectors.
+inline size_t SimdRoundUp(size_t n) {
+  return (n + kSimdWidth - 1) & ~(kSimdWidth - 1);
+}
+
+}  // namespace stmlib
+
+#endif  // STMLIB_DSP_SIMD_H_
@@ -31,7 +31,7 @@
 namespace stmlib {
 
 /* extern */
-const float lut_pitch_ratio_high[] = {
+CACHE_ALIGNED const float lut_pitch_ratio_high[] = {
    6.151958251e-04,  6.517772725e-04,  6.905339660e-04,  7.315952524e-04,
    7.750981699e-04,  8.211879055e-04,  8.700182794e-04,  9.217522585e-04,
    9.765625000e-04,  1.034631928e-03,  1.096154344e-03,  1.161335073e-03,
@@ -99,7 +99,7 @@ const float lut_pitch_ratio_high[] = {
 };
 
 /* extern */
-const float lut_pitch_ratio_low[] = {
+CACHE_ALIGNED const float lut_pitch_ratio_low[] = {
    1.000000000e+00,  1.000225659e+00,  1.000451370e+00,  1.000677131e+00,
    1.000902943e+00,  1.001128806e+00,  1.001354720e+00,  1.001580685e+00,
    1.001806701e+00,  1.002032768e+00,  1.002258886e+00,  1.002485055e+00,
@@ -0,0 +1,47 @@
+// Copyright 2015 Emilie Gillet.
+//
+// Author: Emilie Gillet (emilie.o.gillet@gmail.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+// 
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+// 
+// See http://creativecommons.org/licenses/MIT/ for more information.
+//
+// -----------------------------------------------------------------------------
+//
+// Lookup tables shared by several modules. They are built once, as a library
+// all the plug-ins link to, rather than in each module's resources.cc. The
+// modules' resources.h bring them in their own namespace.
+
+#ifndef STMLIB_RESOURCES_H_
+#define STMLIB_RESOURCES_H_
+
+#include "stmlib/stmlib.h"
+
+namespace stmlib {
+
+extern const float lut_sin[1281];
+extern const float lut_midi_to_f_low[256];
+extern const float lut_fm_frequency_quantizer[129];
+extern const float lut_4_decades[257];
+extern const float lut_svf_shift[257];
+extern const float lut_stiffness[257];
+
+}  // namespace stmlib
+
+#endif  // STMLIB_RESOURCES_H_
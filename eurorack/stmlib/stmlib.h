@@ -81,6 +81,9 @@ namespace impl {
 #define IN_RAM
 #endif  // TEST
 
+// Starts a lookup table on a cache line, so that it spans as few as possible.
+#define CACHE_ALIGNED alignas(64)
+
 #define UNROLL2(x) x; x;
 #define UNROLL4(x) x; x; x; x;
 #define UNROLL8(x) x; x; x; x; x; x; x; x;
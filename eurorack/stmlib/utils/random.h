@@ -25,6 +25,10 @@
 // -----------------------------------------------------------------------------
 //
 // Fast 16-bit pseudo random number generator.
+//
+// The state is per thread. Code which needs its own reproducible sequence
+// (one per UGen instance, for example) binds its state with a
+// ScopedRandomState for the duration of its processing.
 
 #ifndef STMLIB_UTILS_RANDOM_H_
 #define STMLIB_UTILS_RANDOM_H_
@@ -55,11 +59,31 @@ class Random {
   }
 
  private:
-  static uint32_t rng_state_;
+  static thread_local uint32_t rng_state_;
 
   DISALLOW_COPY_AND_ASSIGN(Random);
 };
 
+// The UGens keep one state per instance, bound in the Ctor and in the calc
+// function. It comes from the seed input or, if that is 0, from the random
+// generator of the synth's graph, so that RandSeed makes the sequence
+// reproducible.
+class ScopedRandomState {
+ public:
+  ScopedRandomState(uint32_t* state) : state_(state) {
+    Random::Seed(*state);
+  }
+  
+  ~ScopedRandomState() {
+    *state_ = Random::state();
+  }
+  
+ private:
+  uint32_t* state_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedRandomState);
+};
+
 }  // namespace stmlib
 
 #endif  // STMLIB_UTILS_RANDOM_H_
@@ -88,5 +88,10 @@ Ratio PolySlopeGenerator::control_ratio_table_[21][PolySlopeGenerator::num_chann
 PolySlopeGenerator::RenderFn PolySlopeGenerator::render_fn_table_[RAMP_MODE_LAST][
     OUTPUT_MODE_LAST][RANGE_LAST];
 
+/* static */
+PolySlopeGenerator::RenderAudioRateFn
+PolySlopeGenerator::render_audio_rate_fn_table_[RAMP_MODE_LAST][
+    OUTPUT_MODE_LAST][RANGE_LAST];
+
 
 }  // namespace tides
@@ -41,10 +41,14 @@
 namespace tides {
 
 #define INSTANTIATE(x, y, z) \
-  render_fn_table_[x][y][z] = &PolySlopeGenerator::RenderInternal<x, y, z>;
+  render_fn_table_[x][y][z] = &PolySlopeGenerator::RenderInternal<x, y, z>; \
+  render_audio_rate_fn_table_[x][y][z] = \
+      &PolySlopeGenerator::RenderInternalAudioRate<x, y, z>;
 
 #define INSTANTIATE_RAM(x, y, z) \
-  render_fn_table_[x][y][z] = &PolySlopeGenerator::RenderInternal_RAM<x, y, z>;
+  render_fn_table_[x][y][z] = &PolySlopeGenerator::RenderInternal_RAM<x, y, z>; \
+  render_audio_rate_fn_table_[x][y][z] = \
+      &PolySlopeGenerator::RenderInternalAudioRate<x, y, z>;
 
 template<size_t num_channels>
 class Filter {
@@ -79,13 +83,29 @@ class Filter {
   DISALLOW_COPY_AND_ASSIGN(Filter);
 };
 
+// Parameter values computed beforehand for each sample, read like the ones
+// interpolated over a block.
+class ParameterBuffer {
+ public:
+  ParameterBuffer(const float* values) : values_(values) { }
+  ~ParameterBuffer() { }
+
+  inline float Next() {
+    return *values_++;
+  }
+
+ private:
+  const float* values_;
+};
+
 class PolySlopeGenerator {
  public:
   PolySlopeGenerator() { }
   ~PolySlopeGenerator() { }
   
   enum {
-    num_channels = 4
+    num_channels = 4,
+    max_audio_rate_block_size = 32
   };
   
   struct OutputSample {
@@ -145,6 +165,12 @@ class PolySlopeGenerator {
       float frequency, float pw, float shape, float smoothness, float shift,
       const stmlib::GateFlags* gate_flags, const float* ramp,
       OutputSample* output, size_t size);
+
+  typedef void (PolySlopeGenerator::*RenderAudioRateFn)(
+      const float* frequency, const float* pw, const float* shift,
+      const float* shape, const float* fold, float quantizer_shift,
+      const stmlib::GateFlags* gate_flags, const float* ramp,
+      OutputSample* output, size_t size);
   
   void Render(
       RampMode ramp_mode,
@@ -213,7 +239,135 @@ class PolySlopeGenerator {
     }
   }
   
+  // Same as above, with a value of each parameter for every sample instead of
+  // a value reached at the end of the block. The smoothing filter and the
+  // frequency ratios still follow the last sample of the block.
+  void Render(
+      RampMode ramp_mode,
+      OutputMode output_mode,
+      Range range,
+      const float* frequency,
+      const float* pw,
+      const float* shape,
+      const float* smoothness,
+      const float* shift,
+      const stmlib::GateFlags* gate_flags,
+      const float* ramp,
+      OutputSample* out,
+      size_t size) {
+    while (size) {
+      size_t block_size = std::min(
+          size, static_cast<size_t>(max_audio_rate_block_size));
+      RenderAudioRateBlock(
+          ramp_mode, output_mode, range,
+          frequency, pw, shape, smoothness, shift,
+          gate_flags, ramp, out, block_size);
+      frequency += block_size;
+      pw += block_size;
+      shape += block_size;
+      smoothness += block_size;
+      shift += block_size;
+      gate_flags += block_size;
+      if (ramp) {
+        ramp += block_size;
+      }
+      out += block_size;
+      size -= block_size;
+    }
+  }
+  
  private:
+  void RenderAudioRateBlock(
+      RampMode ramp_mode,
+      OutputMode output_mode,
+      Range range,
+      const float* frequency,
+      const float* pw,
+      const float* shape,
+      const float* smoothness,
+      const float* shift,
+      const stmlib::GateFlags* gate_flags,
+      const float* ramp,
+      OutputSample* out,
+      size_t size) {
+    const bool is_phasor = !(range == RANGE_AUDIO && \
+        ramp_mode == RAMP_MODE_LOOPING);
+    const float shape_scale = is_phasor ? 5.9999f : 3.9999f;
+    const float shape_offset = is_phasor ? 5.0f : 0.0f;
+    const bool control_pw = range == RANGE_CONTROL;
+    const bool trapezoid = ramp && ramp_mode == RAMP_MODE_AR;
+    
+    float f0_buffer[max_audio_rate_block_size];
+    float pw_buffer[max_audio_rate_block_size];
+    float shift_buffer[max_audio_rate_block_size];
+    float shape_buffer[max_audio_rate_block_size];
+    float fold_buffer[max_audio_rate_block_size];
+    
+    // The per-block parameter conditioning of Render(), for every sample.
+    for (size_t i = 0; i < size; ++i) {
+      float f0 = std::min(frequency[i], 0.25f);
+      // Unlike a smoothed control, an audio rate input can sit exactly at the
+      // ends of its range, where the slopes are infinite at zero frequency.
+      float pw_i = pw[i];
+      CONSTRAIN(pw_i, 0.0001f, 0.9999f);
+      if (control_pw && pw_i < 0.5f) {
+        pw_i = 0.5f + 0.6f * (pw_i - 0.5f) / (fabsf(pw_i - 0.5f) + 0.1f);
+      }
+      if (trapezoid) {
+        f0 *= 1.0f + 2.0f * fabsf(pw_i - 0.5f);
+      }
+      
+      const float slope = 3.0f + fabsf(pw_i - 0.5f) * 5.0f;
+      const float shape_amount = fabsf(shape[i] - 0.5f) * 2.0f;
+      const float shape_amount_attenuation = Tame(f0, slope, 16.0f);
+      const float shape_i = 0.5f + (shape[i] - 0.5f) * shape_amount_attenuation;
+      
+      float smoothness_i = smoothness[i];
+      if (smoothness_i > 0.5f) {
+        smoothness_i = 0.5f + (smoothness_i - 0.5f) * Tame(
+            f0,
+            slope * (3.0f + shape_amount * shape_amount_attenuation * 5.0f),
+            12.0f);
+      }
+      
+      f0_buffer[i] = f0;
+      pw_buffer[i] = pw_i;
+      shift_buffer[i] = 2.0f * shift[i] - 1.0f;
+      shape_buffer[i] = shape_i * shape_scale + shape_offset;
+      fold_buffer[i] = std::max(2.0f * (smoothness_i - 0.5f), 0.0f);
+    }
+    
+    (this->*render_audio_rate_fn_table_[ramp_mode][output_mode][range])(
+        f0_buffer, pw_buffer, shift_buffer, shape_buffer, fold_buffer,
+        shift[size - 1], gate_flags, ramp, out, size);
+    
+    // Where the interpolated parameters would start from on the next block.
+    frequency_ = f0_buffer[size - 1];
+    pw_ = pw_buffer[size - 1];
+    shift_ = shift_buffer[size - 1];
+    shape_ = shape_buffer[size - 1];
+    fold_ = fold_buffer[size - 1];
+    
+    if (smoothness[size - 1] < 0.5f) {
+      float ratio = smoothness[size - 1] * 2.0f;
+      ratio *= ratio;
+      ratio *= ratio;
+      
+      float f[4];
+      size_t last_channel = output_mode == OUTPUT_MODE_GATES ? 1 : num_channels;
+      for (size_t i = 0; i < last_channel; ++i) {
+        size_t source = output_mode == OUTPUT_MODE_FREQUENCY ? i : 0;
+        f[i] = ramp_generator_.frequency(source) * 0.5f;
+        f[i] += (1.0f - f[i]) * ratio;
+      }
+      if (output_mode == OUTPUT_MODE_GATES) {
+        filter_.Process<1>(f, &out[0].channel[0], size);
+      } else {
+        filter_.Process<num_channels>(f, &out[0].channel[0], size);
+      }
+    }
+  }
+  
   template<RampMode ramp_mode, OutputMode output_mode, Range range>
   inline void RenderInternal(
       float frequency,
@@ -237,6 +391,38 @@ class PolySlopeGenerator {
     stmlib::ParameterInterpolator fold_modulation(
         &fold_, std::max(2.0f * (smoothness - 0.5f), 0.0f), size);
     
+    SetRatios<output_mode, range>(shift);
+    RenderSamples<ramp_mode, output_mode, range>(
+        &fm, &pwm, &shift_modulation, &shape_modulation, &fold_modulation,
+        gate_flags, ramp, out, size);
+  }
+  
+  template<RampMode ramp_mode, OutputMode output_mode, Range range>
+  void RenderInternalAudioRate(
+      const float* frequency,
+      const float* pw,
+      const float* shift,
+      const float* shape,
+      const float* fold,
+      float quantizer_shift,
+      const stmlib::GateFlags* gate_flags,
+      const float* ramp,
+      OutputSample* out,
+      size_t size) {
+    ParameterBuffer fm(frequency);
+    ParameterBuffer pwm(pw);
+    ParameterBuffer shift_modulation(shift);
+    ParameterBuffer shape_modulation(shape);
+    ParameterBuffer fold_modulation(fold);
+    
+    SetRatios<output_mode, range>(quantizer_shift);
+    RenderSamples<ramp_mode, output_mode, range>(
+        &fm, &pwm, &shift_modulation, &shape_modulation, &fold_modulation,
+        gate_flags, ramp, out, size);
+  }
+  
+  template<OutputMode output_mode, Range range>
+  inline void SetRatios(float shift) {
     if (output_mode == OUTPUT_MODE_FREQUENCY) {
       const int ratio_index = ratio_index_quantizer_.Process(shift, 21, 0.01f);
       if (range == RANGE_CONTROL) {
@@ -245,14 +431,30 @@ class PolySlopeGenerator {
         ramp_generator_.set_next_ratio(audio_ratio_table_[ratio_index]);
       }
     }
-    
+  }
+  
+  template<RampMode ramp_mode, OutputMode output_mode, Range range,
+           typename Modulation>
+  inline void RenderSamples(
+      Modulation* fm,
+      Modulation* pwm,
+      Modulation* shift_modulation,
+      Modulation* shape_modulation,
+      Modulation* fold_modulation,
+      const stmlib::GateFlags* gate_flags,
+      const float* ramp,
+      OutputSample* out,
+      size_t size) {
+    const bool is_phasor = !(range == RANGE_AUDIO && \
+        ramp_mode == RAMP_MODE_LOOPING);
+
     for (size_t i = 0; i < size; ++i) {
-      const float f0 = fm.Next();
-      const float pw = pwm.Next();
-      const float shift = shift_modulation.Next();
+      const float f0 = fm->Next();
+      const float pw = pwm->Next();
+      const float shift = shift_modulation->Next();
       const float step = shift * (1.0f / (num_channels - 1));
       const float partial_step = shift * (1.0f / num_channels);
-      const float fold = fold_modulation.Next();
+      const float fold = fold_modulation->Next();
 
       float per_channel_pw[num_channels];
       const float pw_increment = (shift > 0.0f ? (1.0f - pw) : pw) * step;
@@ -280,7 +482,7 @@ class PolySlopeGenerator {
       }
       
       // Compute shape.
-      const float shape = shape_modulation.Next();
+      const float shape = shape_modulation->Next();
       MAKE_INTEGRAL_FRACTIONAL(shape);
       const int16_t* shape_table = &lut_wavetable[shape_integral * 1025];
       
@@ -419,6 +621,8 @@ class PolySlopeGenerator {
   static Ratio control_ratio_table_[21][num_channels];
   static RenderFn render_fn_table_[RAMP_MODE_LAST][OUTPUT_MODE_LAST][
       RANGE_LAST];
+  static RenderAudioRateFn render_audio_rate_fn_table_[RAMP_MODE_LAST][
+      OUTPUT_MODE_LAST][RANGE_LAST];
 
   DISALLOW_COPY_AND_ASSIGN(PolySlopeGenerator);
 };
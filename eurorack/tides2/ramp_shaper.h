@@ -62,7 +62,10 @@ class RampShaper {
     }
     
     if (going_up_ ^ (phase < pw)) {
-      float t = (phase - wrap_point) / frequency;
+      // the edge can also be crossed by a modulated pw while the phase
+      // (almost) stands still: keep 't' within reasonable values.
+      float t = frequency != 0.0f ? (phase - wrap_point) / frequency : 0.0f;
+      CONSTRAIN(t, -1.0f, 2.0f);
       float discontinuity = 1.0f;
       if (wrap_point != pw) {
         discontinuity = -discontinuity;
@@ -35,6 +35,7 @@
 
 
 #include "stmlib/stmlib.h"
+#include "stmlib/resources.h"
 
 
 
@@ -46,7 +47,7 @@ extern const float* lookup_table_table[];
 
 extern const int16_t* lookup_table_i16_table[];
 
-extern const float lut_sine[];
+using stmlib::lut_sin;
 extern const float lut_bipolar_fold[];
 extern const float lut_unipolar_fold[];
 extern const int16_t lut_wavetable[];
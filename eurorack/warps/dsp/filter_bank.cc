@@ -46,38 +46,47 @@ void FilterBank::Init(float sample_rate) {
   int32_t max_delay = 0;
   float* samples = &samples_[0];
   
-  int32_t group = -1;
-  int32_t decimation_factor = -1;
-  for (int32_t i = 0; i < kNumBands; ++i) {
-    const float* coefficients = filter_bank_table[i];
-
-    Band& b = band_[i];
-
-    b.decimation_factor = static_cast<int32_t>(coefficients[0]);
-    
-    if (b.decimation_factor != decimation_factor) {
-      decimation_factor = b.decimation_factor;
-      ++group;
-    }
+  const int32_t num_bands[kNumGroups] = {
+    kNumLowBands, kNumMidBands, kNumHighBands
+  };
+  int32_t first_band = 0;
+  size_t first_lane = 0;
+  for (int32_t g = 0; g < kNumGroups; ++g) {
+    BandGroup& group = group_[g];
+    group.decimation_factor = static_cast<int32_t>(
+        filter_bank_table[first_band][0]);
+    group.first_band = first_band;
+    group.num_bands = num_bands[g];
+    group.first_lane = first_lane;
+    group.num_lanes = SimdRoundUp(num_bands[g]);
+    group.samples = samples;
+    samples += kMaxFilterBankBlockSize / group.decimation_factor * \
+        group.num_lanes;
+    fill(&group.samples[0], samples, 0.0f);
     
-    b.group = group;
-    b.sample_rate = sample_rate / static_cast<float>(b.decimation_factor);
-    b.samples = samples;
-    samples += kMaxFilterBankBlockSize / b.decimation_factor;
-    
-    b.delay = static_cast<int32_t>(coefficients[1]);
-    b.delay *= b.decimation_factor;
-    b.post_gain = coefficients[2];
-
-    max_delay = max(max_delay, b.delay);
-    for (int32_t pass = 0; pass < 2; ++pass) {
-      b.svf[pass].Init();
-      b.svf[pass].set_f_fq(
-          coefficients[pass * 2 + 3],
-          coefficients[pass * 2 + 4]);
+    for (size_t j = 0; j < group.num_lanes; ++j) {
+      // Padding lanes run a copy of the last band of the group, muted.
+      int32_t i = first_band + min(j, size_t(group.num_bands - 1));
+      const float* coefficients = filter_bank_table[i];
+      InitLane(first_lane + j, coefficients, i);
+      if (j >= size_t(group.num_bands)) {
+        post_gain_[first_lane + j] = 0.0f;
+        continue;
+      }
+      
+      Band& b = band_[i];
+      b.decimation_factor = static_cast<int32_t>(coefficients[0]);
+      b.group = g;
+      b.lane = first_lane + j;
+      b.sample_rate = sample_rate / static_cast<float>(b.decimation_factor);
+      b.delay = static_cast<int32_t>(coefficients[1]);
+      b.delay *= b.decimation_factor;
+      max_delay = max(max_delay, b.delay);
     }
+    first_band += group.num_bands;
+    first_lane += group.num_lanes;
   }
-  band_[kNumBands].group = band_[kNumBands - 1].group + 1;
+  
   max_delay = min(max_delay, int32_t(256));
   float* delay_ptr = &delay_buffer_[0];
   for (int32_t i = 0; i < kNumBands; ++i) {
@@ -98,58 +107,146 @@ void FilterBank::Init(float sample_rate) {
   }
 }
 
+void FilterBank::InitLane(size_t lane, const float* coefficients, int32_t band) {
+  bool low_pass = band == 0;
+  bool high_pass = band == kNumBands - 1;
+  for (int32_t pass = 0; pass < 2; ++pass) {
+    float f = coefficients[pass * 2 + 3];
+    float fq = coefficients[pass * 2 + 4];
+    f_[pass][lane] = f;
+    fq_[pass][lane] = fq;
+    lp_gain_[pass][lane] = low_pass ? f : (high_pass ? -f : 0.0f);
+    bp_gain_[pass][lane] = low_pass ? 0.0f : (high_pass ? -fq : fq);
+  }
+  x_gain_[lane] = high_pass ? 1.0f : 0.0f;
+  bp_x_gain_[lane] = low_pass || high_pass ? 0.0f : 1.0f;
+  post_gain_[lane] = coefficients[2];
+  for (int32_t stage = 0; stage < 4; ++stage) {
+    lp_[stage][lane] = bp_[stage][lane] = x_[stage][lane] = 0.0f;
+  }
+}
+
+void FilterBank::ProcessLanes(
+    size_t lane,
+    const float* in,
+    float* out,
+    size_t out_stride,
+    size_t size) {
+  SimdFloat f[2];
+  SimdFloat minus_fq[2];
+  SimdFloat lp_gain[2];
+  SimdFloat bp_gain[2];
+  for (int32_t pass = 0; pass < 2; ++pass) {
+    f[pass] = SimdFloat::Load(&f_[pass][lane]);
+    minus_fq[pass] = SimdFloat::Broadcast(0.0f) - \
+        SimdFloat::Load(&fq_[pass][lane]);
+    lp_gain[pass] = SimdFloat::Load(&lp_gain_[pass][lane]);
+    bp_gain[pass] = SimdFloat::Load(&bp_gain_[pass][lane]);
+  }
+  const SimdFloat x_gain = SimdFloat::Load(&x_gain_[lane]);
+  const SimdFloat bp_x_gain = SimdFloat::Load(&bp_x_gain_[lane]);
+  const SimdFloat post_gain = SimdFloat::Load(&post_gain_[lane]);
+  
+  SimdFloat lp[4];
+  SimdFloat bp[4];
+  SimdFloat x[4];
+  for (int32_t stage = 0; stage < 4; ++stage) {
+    lp[stage] = SimdFloat::Load(&lp_[stage][lane]);
+    bp[stage] = SimdFloat::Load(&bp_[stage][lane]);
+    x[stage] = SimdFloat::Load(&x_[stage][lane]);
+  }
+  
+#define TICK(stage, in) { \
+    const int32_t pass = stage >> 1; \
+    const SimdFloat s = in; \
+    lp[stage] = lp[stage] + f[pass] * bp[stage]; \
+    bp[stage] = bp[stage] + \
+        (minus_fq[pass] * bp[stage] - f[pass] * lp[stage] + s); \
+    bp[stage] = bp[stage] + bp_x_gain * x[stage]; \
+    x[stage] = s; \
+    y[stage] = x_gain * s + lp_gain[pass] * lp[stage] + \
+        bp_gain[pass] * bp[stage]; \
+  }
+  
+  // The four stages are software-pipelined: during the n-th iteration, stage k
+  // processes the sample n - k. The four updates of an iteration are thus
+  // independent of each other, instead of forming a long dependency chain.
+  SimdFloat y[4];
+  for (size_t n = 0; n < size + 3; ++n) {
+    if (n >= 3 && n < size) {
+      TICK(3, y[2]);
+      TICK(2, y[1]);
+      TICK(1, y[0]);
+      TICK(0, SimdFloat::Broadcast(in[n]));
+    } else {
+      if (n >= 3) {
+        TICK(3, y[2]);
+      }
+      if (n >= 2 && n < size + 2) {
+        TICK(2, y[1]);
+      }
+      if (n >= 1 && n < size + 1) {
+        TICK(1, y[0]);
+      }
+      if (n < size) {
+        TICK(0, SimdFloat::Broadcast(in[n]));
+      }
+    }
+    if (n >= 3) {
+      (y[3] * post_gain).Store(out);
+      out += out_stride;
+    }
+  }
+  
+#undef TICK
+  
+  for (int32_t stage = 0; stage < 4; ++stage) {
+    lp[stage].Store(&lp_[stage][lane]);
+    bp[stage].Store(&bp_[stage][lane]);
+    x[stage].Store(&x_[stage][lane]);
+  }
+}
+
 void FilterBank::Analyze(const float* in, size_t size) {
   mid_src_down_.Process(in, tmp_[0], size);
   low_src_down_.Process(tmp_[0], tmp_[1], size / kMidFactor);
   
-  const float* sources[3] = { tmp_[1], tmp_[0], in };
-  for (int32_t i = 0; i < kNumBands; ++i) {
-    Band& b = band_[i];
-    const size_t band_size = size / b.decimation_factor;
-    const float* input = sources[b.group];
-    
-    for (int32_t pass = 0; pass < 2; ++pass) {
-      const float* source = pass == 0 ? input : b.samples;
-      float* destination = b.samples;
-      if (i == 0) {
-        b.svf[pass].Process<FILTER_MODE_LOW_PASS>(
-            source, destination, band_size);
-      } else if (i == kNumBands - 1) {
-        b.svf[pass].Process<FILTER_MODE_HIGH_PASS>(
-            source, destination, band_size);
-      } else {
-        b.svf[pass].Process<FILTER_MODE_BAND_PASS_NORMALIZED>(
-            source, destination, band_size);
-      }
-    }
-    // Apply post-gain
-    const float gain = b.post_gain;
-    float* output = b.samples;
-    for (size_t i = 0; i < band_size; ++i) {
-      output[i] *= gain;
+  const float* sources[kNumGroups] = { tmp_[1], tmp_[0], in };
+  for (int32_t g = 0; g < kNumGroups; ++g) {
+    const BandGroup& group = group_[g];
+    const size_t band_size = size / group.decimation_factor;
+    for (size_t j = 0; j < group.num_lanes; j += kSimdWidth) {
+      ProcessLanes(
+          group.first_lane + j,
+          sources[g],
+          &group.samples[j],
+          group.num_lanes,
+          band_size);
     }
   }
 }
 
 void FilterBank::Synthesize(float* out, size_t size) {
-  float* buffers[3] = { tmp_[1], tmp_[0], out };
+  float* buffers[kNumGroups] = { tmp_[1], tmp_[0], out };
 
-  fill(&buffers[0][0], &buffers[0][size / band_[0].decimation_factor], 0.0f);
-  for (int32_t i = 0; i < kNumBands; ++i) {
-    Band& b = band_[i];
+  fill(&buffers[0][0], &buffers[0][size / group_[0].decimation_factor], 0.0f);
+  for (int32_t g = 0; g < kNumGroups; ++g) {
+    const BandGroup& group = group_[g];
     
-    size_t band_size = size / b.decimation_factor;
-    float* s = buffers[b.group];
-    for (size_t j = 0; j < band_size; ++j) {
-      s[j] += b.delay_line.ReadWrite(b.samples[j]);
+    size_t band_size = size / group.decimation_factor;
+    float* s = buffers[g];
+    for (int32_t i = 0; i < group.num_bands; ++i) {
+      Band& b = band_[group.first_band + i];
+      const float* samples = &group.samples[i];
+      for (size_t j = 0; j < band_size; ++j) {
+        s[j] += b.delay_line.ReadWrite(samples[j * group.num_lanes]);
+      }
     }
     
-    if (band_[i + 1].group != b.group) {
-      if (b.group == 0) {
-        low_src_up_.Process(tmp_[1], tmp_[0], band_size);
-      } else if (b.group == 1) {
-        mid_src_up_.Process(tmp_[0], out, band_size);
-      }
+    if (g == 0) {
+      low_src_up_.Process(tmp_[1], tmp_[0], band_size);
+    } else if (g == 1) {
+      mid_src_up_.Process(tmp_[0], out, band_size);
     }
   }
 }
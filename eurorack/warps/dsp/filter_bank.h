@@ -33,6 +33,7 @@
 
 #include "stmlib/dsp/dsp.h"
 #include "stmlib/dsp/filter.h"
+#include "stmlib/dsp/simd.h"
 
 #include "warps/dsp/sample_rate_converter.h"
 #include "warps/resources.h"
@@ -44,7 +45,27 @@ const int32_t kLowFactor = 4;
 const int32_t kMidFactor = 3;
 const int32_t kDelayLineSize = 6144;
 const int32_t kMaxFilterBankBlockSize = 96;   // TODO check blockSize
-const int32_t kSampleMemorySize = kMaxFilterBankBlockSize * kNumBands / 2;
+
+// Bands of filter_bank_table running at 8kHz, 32kHz and 96kHz.
+const int32_t kNumGroups = 3;
+const int32_t kNumLowBands = 13;
+const int32_t kNumMidBands = 6;
+const int32_t kNumHighBands = kNumBands - kNumLowBands - kNumMidBands;
+
+// The bands of a group are processed kSimdWidth at a time, each group is
+// padded to a whole number of vectors.
+const size_t kNumLowLanes = (kNumLowBands + stmlib::kSimdWidth - 1) &
+    ~(stmlib::kSimdWidth - 1);
+const size_t kNumMidLanes = (kNumMidBands + stmlib::kSimdWidth - 1) &
+    ~(stmlib::kSimdWidth - 1);
+const size_t kNumHighLanes = (kNumHighBands + stmlib::kSimdWidth - 1) &
+    ~(stmlib::kSimdWidth - 1);
+const size_t kNumLanes = kNumLowLanes + kNumMidLanes + kNumHighLanes;
+
+const size_t kSampleMemorySize = \
+    kMaxFilterBankBlockSize / (kLowFactor * kMidFactor) * kNumLowLanes + \
+    kMaxFilterBankBlockSize / kMidFactor * kNumMidLanes + \
+    kMaxFilterBankBlockSize * kNumHighLanes;
 
 class PooledDelayLine {
  public:
@@ -62,7 +83,9 @@ class PooledDelayLine {
   
   float ReadWrite(float value) {
     delay_line_[head_] = value;
-    head_ = (head_ + 1) % size_;
+    if (++head_ >= size_) {
+      head_ = 0;
+    }
     return delay_line_[head_];
   };
   
@@ -76,15 +99,24 @@ class PooledDelayLine {
 
 struct Band {
   int32_t group;
+  int32_t lane;
   float sample_rate;
-  float post_gain;
-  stmlib::CrossoverSvf svf[2];
   int32_t decimation_factor;
-  float* samples;
   PooledDelayLine delay_line;
   int32_t delay;
 };
 
+struct BandGroup {
+  int32_t decimation_factor;
+  int32_t first_band;
+  int32_t num_bands;
+  size_t first_lane;
+  size_t num_lanes;
+  // Interleaved: samples[i * num_lanes + j] is the i-th sample of the band
+  // first_band + j.
+  float* samples;
+};
+
 class FilterBank {
  public:
   FilterBank() { }
@@ -92,11 +124,22 @@ class FilterBank {
   void Init(float sample_rate);
   void Analyze(const float* in, size_t size);
   void Synthesize(float* out, size_t size);
-  const Band& band(int32_t index) {
+  const Band& band(int32_t index) const {
     return band_[index];
   }
+  const BandGroup& group(int32_t index) const {
+    return group_[index];
+  }
   
  private:
+  void InitLane(size_t lane, const float* coefficients, int32_t band);
+  void ProcessLanes(
+      size_t lane,
+      const float* in,
+      float* out,
+      size_t out_stride,
+      size_t size);
+
   SampleRateConverter<SRC_DOWN, kMidFactor, 36> mid_src_down_;
   SampleRateConverter<SRC_UP, kMidFactor, 36> mid_src_up_;
   SampleRateConverter<SRC_DOWN, kLowFactor, 48> low_src_down_;
@@ -106,7 +149,25 @@ class FilterBank {
   float samples_[kSampleMemorySize];
   float delay_buffer_[kDelayLineSize];
   
-  Band band_[kNumBands + 1];
+  Band band_[kNumBands];
+  BandGroup group_[kNumGroups];
+  
+  // Each band is two cascaded stmlib::CrossoverSvf, that is to say four
+  // SVF stages, the first two with the coefficients of the first pass.
+  // The filter mode is folded into per-lane gains applied to the x, lp and bp
+  // signals of each stage: low-pass (first band), band-pass (normalized), or
+  // high-pass (last band).
+  float f_[2][kNumLanes];
+  float fq_[2][kNumLanes];
+  float lp_gain_[2][kNumLanes];
+  float bp_gain_[2][kNumLanes];
+  float x_gain_[kNumLanes];
+  float bp_x_gain_[kNumLanes];
+  float post_gain_[kNumLanes];
+  
+  float lp_[4][kNumLanes];
+  float bp_[4][kNumLanes];
+  float x_[4][kNumLanes];
   
   DISALLOW_COPY_AND_ASSIGN(FilterBank);
 };
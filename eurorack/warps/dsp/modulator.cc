@@ -791,7 +791,7 @@ void Modulator::Processf(FloatFrame* input, FloatFrame* output, size_t size) {
         //std::cout << "carrier: " << (parameters_.carrier_shape ? 1 : 0)  << "\n";
         // Convert audio inputs to float and apply VCA/saturation (5.8% per channel)
         //short* input_samples = &input->l;
-        for (int32_t i = parameters_.carrier_shape ? 1 : 0; i < 2; ++i) {
+        for (int32_t i = 0; i < 2; ++i) {       // always apply VCA to both inputs
             amplifier_[i].Processff(
                                    parameters_.channel_drive[i],
                                    1.0f - vocoder_amount,
@@ -806,7 +806,8 @@ void Modulator::Processf(FloatFrame* input, FloatFrame* output, size_t size) {
          if (parameters_.carrier_shape) {
              // Scale phase-modulation input.
              for (size_t i = 0; i < size; ++i) {
-             internal_modulation_[i] = input[0][i];
+             // take input AFTER vca/saturation, see Processf()
+             internal_modulation_[i] = carrier[i];
          }
          // Xmod: sine, triangle saw.
          // Vocoder: saw, pulse, noise.
@@ -896,6 +897,7 @@ void Modulator::Processf(FloatFrame* input, FloatFrame* output, size_t size) {
              
              vocoder_.set_release_time(release_time * (2.0f - release_time));
              vocoder_.set_formant_shift(parameters_.modulation_parameter);
+             vocoder_.set_limiter_pre_gain(parameters_.limiter_pre_gain);
              vocoder_.Process(modulator, carrier, main_output, size);
          }
          
@@ -919,11 +921,10 @@ void Modulator::Processf(FloatFrame* input, FloatFrame* output, size_t size) {
          ++aux_output;
          ++output;
          }*/
-        for (int i=0; i<size; i++) {
+        // no hard clipping of the outputs, see Processf()
+        for (size_t i = 0; i < size; i++) {
             float main = main_output[i];
             float aux = aux_output[i] * 0.5f;
-            CONSTRAIN(main, -1.0, 1.0);
-            CONSTRAIN(aux, -1.0, 1.0);
             output[0][i] = main;
             output[1][i] = aux;
         }
@@ -46,15 +46,15 @@ void Vocoder::Init(float sample_rate) {
   release_time_ = 0.5f;
   formant_shift_ = 0.5f;
   
-  BandGain zero;
-  zero.carrier = 0.0f;
-  zero.vocoder = 0.0f;
-  fill(&previous_gain_[0], &previous_gain_[kNumBands], zero);
-  fill(&gain_[0], &gain_[kNumBands], zero);
+  fill(&attack_[0], &attack_[kNumLanes], 0.0f);
+  fill(&decay_[0], &decay_[kNumLanes], 0.0f);
+  fill(&envelope_[0], &envelope_[kNumLanes], 0.0f);
+  fill(&peak_[0], &peak_[kNumLanes], 0.0f);
   
-  for (int32_t i = 0; i < kNumBands; ++i) {
-    follower_[i].Init();
-  }
+  fill(&carrier_gain_[0], &carrier_gain_[kNumLanes], 0.0f);
+  fill(&vocoder_gain_[0], &vocoder_gain_[kNumLanes], 0.0f);
+  fill(&previous_carrier_gain_[0], &previous_carrier_gain_[kNumLanes], 0.0f);
+  fill(&previous_vocoder_gain_[0], &previous_vocoder_gain_[kNumLanes], 0.0f);
     
     limiter_pre_gain_ = 1.4f;       // vb
 }
@@ -69,12 +69,13 @@ void Vocoder::Process(
   carrier_filter_bank_.Analyze(carrier, size);
   
   // Set the attack/release release_time of envelope followers.
+  bool freeze = release_time_ > 0.995f;
   float f = 80.0f * SemitonesToRatio(-72.0f * release_time_);
   for (int32_t i = 0; i < kNumBands; ++i) {
-    float decay = f / modulator_filter_bank_.band(i).sample_rate;
-    follower_[i].set_attack(decay * 2.0f);
-    follower_[i].set_decay(decay * 0.5f);
-    follower_[i].set_freeze(release_time_ > 0.995f);
+    const Band& b = modulator_filter_bank_.band(i);
+    float decay = f / b.sample_rate;
+    attack_[b.lane] = freeze ? 0.0f : decay * 2.0f;
+    decay_[b.lane] = freeze ? 0.0f : decay * 0.5f;
     f *= 1.2599f;  // 2 ** (4/12.0), a third octave.
   }
   
@@ -89,8 +90,8 @@ void Vocoder::Process(
     float source_band = envelope;
     CONSTRAIN(source_band, 0.0f, kLastBand);
     MAKE_INTEGRAL_FRACTIONAL(source_band);
-    float a = follower_[source_band_integral].peak();
-    float b = follower_[source_band_integral + 1].peak();
+    float a = peak_[modulator_filter_bank_.band(source_band_integral).lane];
+    float b = peak_[modulator_filter_bank_.band(source_band_integral + 1).lane];
     float band_gain = (a + (b - a) * source_band_fractional);
     float attenuation = envelope - kLastBand;
     if (attenuation >= 0.0f) {
@@ -98,31 +99,24 @@ void Vocoder::Process(
     }
     envelope += envelope_increment;
 
-    gain_[i].carrier = band_gain * formant_shift_amount;
-    gain_[i].vocoder = 1.0f - formant_shift_amount;
+    int32_t lane = modulator_filter_bank_.band(i).lane;
+    carrier_gain_[lane] = band_gain * formant_shift_amount;
+    vocoder_gain_[lane] = 1.0f - formant_shift_amount;
   }
-        
-  for (int32_t i = 0; i < kNumBands; ++i) {
-    size_t band_size = size / modulator_filter_bank_.band(i).decimation_factor;
-    const float step = 1.0f / static_cast<float>(band_size);
-
-    float* carrier = carrier_filter_bank_.band(i).samples;
-    float* modulator = modulator_filter_bank_.band(i).samples;
-    float* envelope = tmp_;
-
-    follower_[i].Process(modulator, envelope, band_size);
-    
-    float vocoder_gain = previous_gain_[i].vocoder;
-    float vocoder_gain_increment = (gain_[i].vocoder - vocoder_gain) * step;
-    float carrier_gain = previous_gain_[i].carrier;
-    float carrier_gain_increment = (gain_[i].carrier - carrier_gain) * step;
-    for (size_t j = 0; j < band_size; ++j) {
-      carrier[j] *= (carrier_gain + vocoder_gain * envelope[j]);
-      vocoder_gain += vocoder_gain_increment;
-      carrier_gain += carrier_gain_increment;
+  
+  // Run the envelope followers and apply the gains, kSimdWidth bands at a time.
+  for (int32_t g = 0; g < kNumGroups; ++g) {
+    const BandGroup& modulator_group = modulator_filter_bank_.group(g);
+    const BandGroup& carrier_group = carrier_filter_bank_.group(g);
+    size_t band_size = size / modulator_group.decimation_factor;
+    for (size_t j = 0; j < modulator_group.num_lanes; j += kSimdWidth) {
+      ProcessLanes(
+          modulator_group.first_lane + j,
+          &modulator_group.samples[j],
+          &carrier_group.samples[j],
+          modulator_group.num_lanes,
+          band_size);
     }
-    
-    previous_gain_[i] = gain_[i];
   }
 
   carrier_filter_bank_.Synthesize(out, size);
@@ -130,4 +124,53 @@ void Vocoder::Process(
     limiter_.Process(out, limiter_pre_gain_, size);     // vb, spice up the limiter a little
 }
 
+void Vocoder::ProcessLanes(
+    size_t lane,
+    const float* modulator,
+    float* carrier,
+    size_t stride,
+    size_t size) {
+  const SimdFloat follower_gain = SimdFloat::Broadcast(kFollowerGain);
+  const SimdFloat attack = SimdFloat::Load(&attack_[lane]);
+  const SimdFloat decay = SimdFloat::Load(&decay_[lane]);
+  SimdFloat envelope = SimdFloat::Load(&envelope_[lane]);
+  SimdFloat peak = SimdFloat::Broadcast(0.0f);
+  
+  const SimdFloat step = SimdFloat::Broadcast(1.0f / static_cast<float>(size));
+  SimdFloat vocoder_gain = SimdFloat::Load(&previous_vocoder_gain_[lane]);
+  SimdFloat carrier_gain = SimdFloat::Load(&previous_carrier_gain_[lane]);
+  const SimdFloat vocoder_gain_increment = \
+      (SimdFloat::Load(&vocoder_gain_[lane]) - vocoder_gain) * step;
+  const SimdFloat carrier_gain_increment = \
+      (SimdFloat::Load(&carrier_gain_[lane]) - carrier_gain) * step;
+  
+  while (size--) {
+    SimdFloat error = (SimdFloat::Load(modulator) * follower_gain).Abs() - \
+        envelope;
+    envelope = envelope + SimdFloat::SelectPositive(error, attack, decay) * \
+        error;
+    peak = SimdFloat::Max(peak, envelope);
+    
+    SimdFloat c = SimdFloat::Load(carrier);
+    (c * (carrier_gain + vocoder_gain * envelope)).Store(carrier);
+    vocoder_gain = vocoder_gain + vocoder_gain_increment;
+    carrier_gain = carrier_gain + carrier_gain_increment;
+    
+    modulator += stride;
+    carrier += stride;
+  }
+  envelope.Store(&envelope_[lane]);
+  
+  SimdFloat previous_peak = SimdFloat::Load(&peak_[lane]);
+  SimdFloat error = peak - previous_peak;
+  previous_peak = previous_peak + SimdFloat::SelectPositive(
+      error,
+      SimdFloat::Broadcast(0.5f),
+      SimdFloat::Broadcast(0.1f)) * error;
+  previous_peak.Store(&peak_[lane]);
+  
+  SimdFloat::Load(&vocoder_gain_[lane]).Store(&previous_vocoder_gain_[lane]);
+  SimdFloat::Load(&carrier_gain_[lane]).Store(&previous_carrier_gain_[lane]);
+}
+
 }  // namespace warps
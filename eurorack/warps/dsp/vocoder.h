@@ -38,65 +38,6 @@ namespace warps {
 
 const float kFollowerGain = sqrtf(kNumBands);
 
-class EnvelopeFollower {
- public:
-  EnvelopeFollower() { }
-  ~EnvelopeFollower() { }
-  
-  void Init() {
-    envelope_ = 0.0f;
-    freeze_ = false;
-    attack_ = decay_ = 0.1f;
-    peak_ = 0.0f;
-  };
-  
-  void set_attack(float attack) {
-    attack_ = attack;
-  }
-  
-  void set_decay(float decay) {
-    decay_ = decay;
-  }
-  
-  void set_freeze(bool freeze) {
-    freeze_ = freeze;
-  }
-  
-  void Process(const float* in, float* out, size_t size) {
-    float envelope = envelope_;
-    float attack = freeze_ ? 0.0f : attack_;
-    float decay = freeze_ ? 0.0f : decay_;
-    float peak = 0.0f;
-    while (size--) {
-      float error = fabs(*in++ * kFollowerGain) - envelope;
-      envelope += (error > 0.0f ? attack : decay) * error;
-      if (envelope > peak) {
-        peak = envelope;
-      }
-      *out++ = envelope;
-    }
-    envelope_ = envelope;
-    float error = peak - peak_;
-    peak_ += (error > 0.0f ? 0.5f : 0.1f) * error;
-  }
-  
-  inline float peak() const { return peak_; }
-  
- private:
-  float attack_;
-  float decay_;
-  float envelope_;
-  float peak_;
-  float freeze_;
-  
-  DISALLOW_COPY_AND_ASSIGN(EnvelopeFollower);
-};
-
-struct BandGain {
-  float carrier;
-  float vocoder;
-};
-
 class Vocoder {
  public:
   Vocoder() { }
@@ -122,19 +63,32 @@ class Vocoder {
     }
 
  private:
+  void ProcessLanes(
+      size_t lane,
+      const float* modulator,
+      float* carrier,
+      size_t stride,
+      size_t size);
+
   float release_time_;
   float formant_shift_;
     float limiter_pre_gain_;    // vb
   
-  BandGain previous_gain_[kNumBands];
-  BandGain gain_[kNumBands];
-
-  float tmp_[kMaxFilterBankBlockSize];
+  // Envelope followers of the modulator bands, and gains applied to the
+  // carrier bands, indexed by filter bank lane.
+  float attack_[kNumLanes];
+  float decay_[kNumLanes];
+  float envelope_[kNumLanes];
+  float peak_[kNumLanes];
+  
+  float carrier_gain_[kNumLanes];
+  float vocoder_gain_[kNumLanes];
+  float previous_carrier_gain_[kNumLanes];
+  float previous_vocoder_gain_[kNumLanes];
    
   FilterBank modulator_filter_bank_;
   FilterBank carrier_filter_bank_;
   Limiter limiter_;
-  EnvelopeFollower follower_[kNumBands];
   
   DISALLOW_COPY_AND_ASSIGN(Vocoder);
 };
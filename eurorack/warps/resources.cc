@@ -139,329 +139,6 @@ const float* filter_bank_table[] = {
   fb_7040_96000,
 };
 
-const float lut_sin[] = {
-   0.000000000e+00,  6.135884649e-03,  1.227153829e-02,  1.840672991e-02,
-   2.454122852e-02,  3.067480318e-02,  3.680722294e-02,  4.293825693e-02,
-   4.906767433e-02,  5.519524435e-02,  6.132073630e-02,  6.744391956e-02,
-   7.356456360e-02,  7.968243797e-02,  8.579731234e-02,  9.190895650e-02,
-   9.801714033e-02,  1.041216339e-01,  1.102222073e-01,  1.163186309e-01,
-   1.224106752e-01,  1.284981108e-01,  1.345807085e-01,  1.406582393e-01,
-   1.467304745e-01,  1.527971853e-01,  1.588581433e-01,  1.649131205e-01,
-   1.709618888e-01,  1.770042204e-01,  1.830398880e-01,  1.890686641e-01,
-   1.950903220e-01,  2.011046348e-01,  2.071113762e-01,  2.131103199e-01,
-   2.191012402e-01,  2.250839114e-01,  2.310581083e-01,  2.370236060e-01,
-   2.429801799e-01,  2.489276057e-01,  2.548656596e-01,  2.607941179e-01,
-   2.667127575e-01,  2.726213554e-01,  2.785196894e-01,  2.844075372e-01,
-   2.902846773e-01,  2.961508882e-01,  3.020059493e-01,  3.078496400e-01,
-   3.136817404e-01,  3.195020308e-01,  3.253102922e-01,  3.311063058e-01,
-   3.368898534e-01,  3.426607173e-01,  3.484186802e-01,  3.541635254e-01,
-   3.598950365e-01,  3.656129978e-01,  3.713171940e-01,  3.770074102e-01,
-   3.826834324e-01,  3.883450467e-01,  3.939920401e-01,  3.996241998e-01,
-   4.052413140e-01,  4.108431711e-01,  4.164295601e-01,  4.220002708e-01,
-   4.275550934e-01,  4.330938189e-01,  4.386162385e-01,  4.441221446e-01,
-   4.496113297e-01,  4.550835871e-01,  4.605387110e-01,  4.659764958e-01,
-   4.713967368e-01,  4.767992301e-01,  4.821837721e-01,  4.875501601e-01,
-   4.928981922e-01,  4.982276670e-01,  5.035383837e-01,  5.088301425e-01,
-   5.141027442e-01,  5.193559902e-01,  5.245896827e-01,  5.298036247e-01,
-   5.349976199e-01,  5.401714727e-01,  5.453249884e-01,  5.504579729e-01,
-   5.555702330e-01,  5.606615762e-01,  5.657318108e-01,  5.707807459e-01,
-   5.758081914e-01,  5.808139581e-01,  5.857978575e-01,  5.907597019e-01,
-   5.956993045e-01,  6.006164794e-01,  6.055110414e-01,  6.103828063e-01,
-   6.152315906e-01,  6.200572118e-01,  6.248594881e-01,  6.296382389e-01,
-   6.343932842e-01,  6.391244449e-01,  6.438315429e-01,  6.485144010e-01,
-   6.531728430e-01,  6.578066933e-01,  6.624157776e-01,  6.669999223e-01,
-   6.715589548e-01,  6.760927036e-01,  6.806009978e-01,  6.850836678e-01,
-   6.895405447e-01,  6.939714609e-01,  6.983762494e-01,  7.027547445e-01,
-   7.071067812e-01,  7.114321957e-01,  7.157308253e-01,  7.200025080e-01,
-   7.242470830e-01,  7.284643904e-01,  7.326542717e-01,  7.368165689e-01,
-   7.409511254e-01,  7.450577854e-01,  7.491363945e-01,  7.531867990e-01,
-   7.572088465e-01,  7.612023855e-01,  7.651672656e-01,  7.691033376e-01,
-   7.730104534e-01,  7.768884657e-01,  7.807372286e-01,  7.845565972e-01,
-   7.883464276e-01,  7.921065773e-01,  7.958369046e-01,  7.995372691e-01,
-   8.032075315e-01,  8.068475535e-01,  8.104571983e-01,  8.140363297e-01,
-   8.175848132e-01,  8.211025150e-01,  8.245893028e-01,  8.280450453e-01,
-   8.314696123e-01,  8.348628750e-01,  8.382247056e-01,  8.415549774e-01,
-   8.448535652e-01,  8.481203448e-01,  8.513551931e-01,  8.545579884e-01,
-   8.577286100e-01,  8.608669386e-01,  8.639728561e-01,  8.670462455e-01,
-   8.700869911e-01,  8.730949784e-01,  8.760700942e-01,  8.790122264e-01,
-   8.819212643e-01,  8.847970984e-01,  8.876396204e-01,  8.904487232e-01,
-   8.932243012e-01,  8.959662498e-01,  8.986744657e-01,  9.013488470e-01,
-   9.039892931e-01,  9.065957045e-01,  9.091679831e-01,  9.117060320e-01,
-   9.142097557e-01,  9.166790599e-01,  9.191138517e-01,  9.215140393e-01,
-   9.238795325e-01,  9.262102421e-01,  9.285060805e-01,  9.307669611e-01,
-   9.329927988e-01,  9.351835099e-01,  9.373390119e-01,  9.394592236e-01,
-   9.415440652e-01,  9.435934582e-01,  9.456073254e-01,  9.475855910e-01,
-   9.495281806e-01,  9.514350210e-01,  9.533060404e-01,  9.551411683e-01,
-   9.569403357e-01,  9.587034749e-01,  9.604305194e-01,  9.621214043e-01,
-   9.637760658e-01,  9.653944417e-01,  9.669764710e-01,  9.685220943e-01,
-   9.700312532e-01,  9.715038910e-01,  9.729399522e-01,  9.743393828e-01,
-   9.757021300e-01,  9.770281427e-01,  9.783173707e-01,  9.795697657e-01,
-   9.807852804e-01,  9.819638691e-01,  9.831054874e-01,  9.842100924e-01,
-   9.852776424e-01,  9.863080972e-01,  9.873014182e-01,  9.882575677e-01,
-   9.891765100e-01,  9.900582103e-01,  9.909026354e-01,  9.917097537e-01,
-   9.924795346e-01,  9.932119492e-01,  9.939069700e-01,  9.945645707e-01,
-   9.951847267e-01,  9.957674145e-01,  9.963126122e-01,  9.968202993e-01,
-   9.972904567e-01,  9.977230666e-01,  9.981181129e-01,  9.984755806e-01,
-   9.987954562e-01,  9.990777278e-01,  9.993223846e-01,  9.995294175e-01,
-   9.996988187e-01,  9.998305818e-01,  9.999247018e-01,  9.999811753e-01,
-   1.000000000e+00,  9.999811753e-01,  9.999247018e-01,  9.998305818e-01,
-   9.996988187e-01,  9.995294175e-01,  9.993223846e-01,  9.990777278e-01,
-   9.987954562e-01,  9.984755806e-01,  9.981181129e-01,  9.977230666e-01,
-   9.972904567e-01,  9.968202993e-01,  9.963126122e-01,  9.957674145e-01,
-   9.951847267e-01,  9.945645707e-01,  9.939069700e-01,  9.932119492e-01,
-   9.924795346e-01,  9.917097537e-01,  9.909026354e-01,  9.900582103e-01,
-   9.891765100e-01,  9.882575677e-01,  9.873014182e-01,  9.863080972e-01,
-   9.852776424e-01,  9.842100924e-01,  9.831054874e-01,  9.819638691e-01,
-   9.807852804e-01,  9.795697657e-01,  9.783173707e-01,  9.770281427e-01,
-   9.757021300e-01,  9.743393828e-01,  9.729399522e-01,  9.715038910e-01,
-   9.700312532e-01,  9.685220943e-01,  9.669764710e-01,  9.653944417e-01,
-   9.637760658e-01,  9.621214043e-01,  9.604305194e-01,  9.587034749e-01,
-   9.569403357e-01,  9.551411683e-01,  9.533060404e-01,  9.514350210e-01,
-   9.495281806e-01,  9.475855910e-01,  9.456073254e-01,  9.435934582e-01,
-   9.415440652e-01,  9.394592236e-01,  9.373390119e-01,  9.351835099e-01,
-   9.329927988e-01,  9.307669611e-01,  9.285060805e-01,  9.262102421e-01,
-   9.238795325e-01,  9.215140393e-01,  9.191138517e-01,  9.166790599e-01,
-   9.142097557e-01,  9.117060320e-01,  9.091679831e-01,  9.065957045e-01,
-   9.039892931e-01,  9.013488470e-01,  8.986744657e-01,  8.959662498e-01,
-   8.932243012e-01,  8.904487232e-01,  8.876396204e-01,  8.847970984e-01,
-   8.819212643e-01,  8.790122264e-01,  8.760700942e-01,  8.730949784e-01,
-   8.700869911e-01,  8.670462455e-01,  8.639728561e-01,  8.608669386e-01,
-   8.577286100e-01,  8.545579884e-01,  8.513551931e-01,  8.481203448e-01,
-   8.448535652e-01,  8.415549774e-01,  8.382247056e-01,  8.348628750e-01,
-   8.314696123e-01,  8.280450453e-01,  8.245893028e-01,  8.211025150e-01,
-   8.175848132e-01,  8.140363297e-01,  8.104571983e-01,  8.068475535e-01,
-   8.032075315e-01,  7.995372691e-01,  7.958369046e-01,  7.921065773e-01,
-   7.883464276e-01,  7.845565972e-01,  7.807372286e-01,  7.768884657e-01,
-   7.730104534e-01,  7.691033376e-01,  7.651672656e-01,  7.612023855e-01,
-   7.572088465e-01,  7.531867990e-01,  7.491363945e-01,  7.450577854e-01,
-   7.409511254e-01,  7.368165689e-01,  7.326542717e-01,  7.284643904e-01,
-   7.242470830e-01,  7.200025080e-01,  7.157308253e-01,  7.114321957e-01,
-   7.071067812e-01,  7.027547445e-01,  6.983762494e-01,  6.939714609e-01,
-   6.895405447e-01,  6.850836678e-01,  6.806009978e-01,  6.760927036e-01,
-   6.715589548e-01,  6.669999223e-01,  6.624157776e-01,  6.578066933e-01,
-   6.531728430e-01,  6.485144010e-01,  6.438315429e-01,  6.391244449e-01,
-   6.343932842e-01,  6.296382389e-01,  6.248594881e-01,  6.200572118e-01,
-   6.152315906e-01,  6.103828063e-01,  6.055110414e-01,  6.006164794e-01,
-   5.956993045e-01,  5.907597019e-01,  5.857978575e-01,  5.808139581e-01,
-   5.758081914e-01,  5.707807459e-01,  5.657318108e-01,  5.606615762e-01,
-   5.555702330e-01,  5.504579729e-01,  5.453249884e-01,  5.401714727e-01,
-   5.349976199e-01,  5.298036247e-01,  5.245896827e-01,  5.193559902e-01,
-   5.141027442e-01,  5.088301425e-01,  5.035383837e-01,  4.982276670e-01,
-   4.928981922e-01,  4.875501601e-01,  4.821837721e-01,  4.767992301e-01,
-   4.713967368e-01,  4.659764958e-01,  4.605387110e-01,  4.550835871e-01,
-   4.496113297e-01,  4.441221446e-01,  4.386162385e-01,  4.330938189e-01,
-   4.275550934e-01,  4.220002708e-01,  4.164295601e-01,  4.108431711e-01,
-   4.052413140e-01,  3.996241998e-01,  3.939920401e-01,  3.883450467e-01,
-   3.826834324e-01,  3.770074102e-01,  3.713171940e-01,  3.656129978e-01,
-   3.598950365e-01,  3.541635254e-01,  3.484186802e-01,  3.426607173e-01,
-   3.368898534e-01,  3.311063058e-01,  3.253102922e-01,  3.195020308e-01,
-   3.136817404e-01,  3.078496400e-01,  3.020059493e-01,  2.961508882e-01,
-   2.902846773e-01,  2.844075372e-01,  2.785196894e-01,  2.726213554e-01,
-   2.667127575e-01,  2.607941179e-01,  2.548656596e-01,  2.489276057e-01,
-   2.429801799e-01,  2.370236060e-01,  2.310581083e-01,  2.250839114e-01,
-   2.191012402e-01,  2.131103199e-01,  2.071113762e-01,  2.011046348e-01,
-   1.950903220e-01,  1.890686641e-01,  1.830398880e-01,  1.770042204e-01,
-   1.709618888e-01,  1.649131205e-01,  1.588581433e-01,  1.527971853e-01,
-   1.467304745e-01,  1.406582393e-01,  1.345807085e-01,  1.284981108e-01,
-   1.224106752e-01,  1.163186309e-01,  1.102222073e-01,  1.041216339e-01,
-   9.801714033e-02,  9.190895650e-02,  8.579731234e-02,  7.968243797e-02,
-   7.356456360e-02,  6.744391956e-02,  6.132073630e-02,  5.519524435e-02,
-   4.906767433e-02,  4.293825693e-02,  3.680722294e-02,  3.067480318e-02,
-   2.454122852e-02,  1.840672991e-02,  1.227153829e-02,  6.135884649e-03,
-   1.224646799e-16, -6.135884649e-03, -1.227153829e-02, -1.840672991e-02,
-  -2.454122852e-02, -3.067480318e-02, -3.680722294e-02, -4.293825693e-02,
-  -4.906767433e-02, -5.519524435e-02, -6.132073630e-02, -6.744391956e-02,
-  -7.356456360e-02, -7.968243797e-02, -8.579731234e-02, -9.190895650e-02,
-  -9.801714033e-02, -1.041216339e-01, -1.102222073e-01, -1.163186309e-01,
-  -1.224106752e-01, -1.284981108e-01, -1.345807085e-01, -1.406582393e-01,
-  -1.467304745e-01, -1.527971853e-01, -1.588581433e-01, -1.649131205e-01,
-  -1.709618888e-01, -1.770042204e-01, -1.830398880e-01, -1.890686641e-01,
-  -1.950903220e-01, -2.011046348e-01, -2.071113762e-01, -2.131103199e-01,
-  -2.191012402e-01, -2.250839114e-01, -2.310581083e-01, -2.370236060e-01,
-  -2.429801799e-01, -2.489276057e-01, -2.548656596e-01, -2.607941179e-01,
-  -2.667127575e-01, -2.726213554e-01, -2.785196894e-01, -2.844075372e-01,
-  -2.902846773e-01, -2.961508882e-01, -3.020059493e-01, -3.078496400e-01,
-  -3.136817404e-01, -3.195020308e-01, -3.253102922e-01, -3.311063058e-01,
-  -3.368898534e-01, -3.426607173e-01, -3.484186802e-01, -3.541635254e-01,
-  -3.598950365e-01, -3.656129978e-01, -3.713171940e-01, -3.770074102e-01,
-  -3.826834324e-01, -3.883450467e-01, -3.939920401e-01, -3.996241998e-01,
-  -4.052413140e-01, -4.108431711e-01, -4.164295601e-01, -4.220002708e-01,
-  -4.275550934e-01, -4.330938189e-01, -4.386162385e-01, -4.441221446e-01,
-  -4.496113297e-01, -4.550835871e-01, -4.605387110e-01, -4.659764958e-01,
-  -4.713967368e-01, -4.767992301e-01, -4.821837721e-01, -4.875501601e-01,
-  -4.928981922e-01, -4.982276670e-01, -5.035383837e-01, -5.088301425e-01,
-  -5.141027442e-01, -5.193559902e-01, -5.245896827e-01, -5.298036247e-01,
-  -5.349976199e-01, -5.401714727e-01, -5.453249884e-01, -5.504579729e-01,
-  -5.555702330e-01, -5.606615762e-01, -5.657318108e-01, -5.707807459e-01,
-  -5.758081914e-01, -5.808139581e-01, -5.857978575e-01, -5.907597019e-01,
-  -5.956993045e-01, -6.006164794e-01, -6.055110414e-01, -6.103828063e-01,
-  -6.152315906e-01, -6.200572118e-01, -6.248594881e-01, -6.296382389e-01,
-  -6.343932842e-01, -6.391244449e-01, -6.438315429e-01, -6.485144010e-01,
-  -6.531728430e-01, -6.578066933e-01, -6.624157776e-01, -6.669999223e-01,
-  -6.715589548e-01, -6.760927036e-01, -6.806009978e-01, -6.850836678e-01,
-  -6.895405447e-01, -6.939714609e-01, -6.983762494e-01, -7.027547445e-01,
-  -7.071067812e-01, -7.114321957e-01, -7.157308253e-01, -7.200025080e-01,
-  -7.242470830e-01, -7.284643904e-01, -7.326542717e-01, -7.368165689e-01,
-  -7.409511254e-01, -7.450577854e-01, -7.491363945e-01, -7.531867990e-01,
-  -7.572088465e-01, -7.612023855e-01, -7.651672656e-01, -7.691033376e-01,
-  -7.730104534e-01, -7.768884657e-01, -7.807372286e-01, -7.845565972e-01,
-  -7.883464276e-01, -7.921065773e-01, -7.958369046e-01, -7.995372691e-01,
-  -8.032075315e-01, -8.068475535e-01, -8.104571983e-01, -8.140363297e-01,
-  -8.175848132e-01, -8.211025150e-01, -8.245893028e-01, -8.280450453e-01,
-  -8.314696123e-01, -8.348628750e-01, -8.382247056e-01, -8.415549774e-01,
-  -8.448535652e-01, -8.481203448e-01, -8.513551931e-01, -8.545579884e-01,
-  -8.577286100e-01, -8.608669386e-01, -8.639728561e-01, -8.670462455e-01,
-  -8.700869911e-01, -8.730949784e-01, -8.760700942e-01, -8.790122264e-01,
-  -8.819212643e-01, -8.847970984e-01, -8.876396204e-01, -8.904487232e-01,
-  -8.932243012e-01, -8.959662498e-01, -8.986744657e-01, -9.013488470e-01,
-  -9.039892931e-01, -9.065957045e-01, -9.091679831e-01, -9.117060320e-01,
-  -9.142097557e-01, -9.166790599e-01, -9.191138517e-01, -9.215140393e-01,
-  -9.238795325e-01, -9.262102421e-01, -9.285060805e-01, -9.307669611e-01,
-  -9.329927988e-01, -9.351835099e-01, -9.373390119e-01, -9.394592236e-01,
-  -9.415440652e-01, -9.435934582e-01, -9.456073254e-01, -9.475855910e-01,
-  -9.495281806e-01, -9.514350210e-01, -9.533060404e-01, -9.551411683e-01,
-  -9.569403357e-01, -9.587034749e-01, -9.604305194e-01, -9.621214043e-01,
-  -9.637760658e-01, -9.653944417e-01, -9.669764710e-01, -9.685220943e-01,
-  -9.700312532e-01, -9.715038910e-01, -9.729399522e-01, -9.743393828e-01,
-  -9.757021300e-01, -9.770281427e-01, -9.783173707e-01, -9.795697657e-01,
-  -9.807852804e-01, -9.819638691e-01, -9.831054874e-01, -9.842100924e-01,
-  -9.852776424e-01, -9.863080972e-01, -9.873014182e-01, -9.882575677e-01,
-  -9.891765100e-01, -9.900582103e-01, -9.909026354e-01, -9.917097537e-01,
-  -9.924795346e-01, -9.932119492e-01, -9.939069700e-01, -9.945645707e-01,
-  -9.951847267e-01, -9.957674145e-01, -9.963126122e-01, -9.968202993e-01,
-  -9.972904567e-01, -9.977230666e-01, -9.981181129e-01, -9.984755806e-01,
-  -9.987954562e-01, -9.990777278e-01, -9.993223846e-01, -9.995294175e-01,
-  -9.996988187e-01, -9.998305818e-01, -9.999247018e-01, -9.999811753e-01,
-  -1.000000000e+00, -9.999811753e-01, -9.999247018e-01, -9.998305818e-01,
-  -9.996988187e-01, -9.995294175e-01, -9.993223846e-01, -9.990777278e-01,
-  -9.987954562e-01, -9.984755806e-01, -9.981181129e-01, -9.977230666e-01,
-  -9.972904567e-01, -9.968202993e-01, -9.963126122e-01, -9.957674145e-01,
-  -9.951847267e-01, -9.945645707e-01, -9.939069700e-01, -9.932119492e-01,
-  -9.924795346e-01, -9.917097537e-01, -9.909026354e-01, -9.900582103e-01,
-  -9.891765100e-01, -9.882575677e-01, -9.873014182e-01, -9.863080972e-01,
-  -9.852776424e-01, -9.842100924e-01, -9.831054874e-01, -9.819638691e-01,
-  -9.807852804e-01, -9.795697657e-01, -9.783173707e-01, -9.770281427e-01,
-  -9.757021300e-01, -9.743393828e-01, -9.729399522e-01, -9.715038910e-01,
-  -9.700312532e-01, -9.685220943e-01, -9.669764710e-01, -9.653944417e-01,
-  -9.637760658e-01, -9.621214043e-01, -9.604305194e-01, -9.587034749e-01,
-  -9.569403357e-01, -9.551411683e-01, -9.533060404e-01, -9.514350210e-01,
-  -9.495281806e-01, -9.475855910e-01, -9.456073254e-01, -9.435934582e-01,
-  -9.415440652e-01, -9.394592236e-01, -9.373390119e-01, -9.351835099e-01,
-  -9.329927988e-01, -9.307669611e-01, -9.285060805e-01, -9.262102421e-01,
-  -9.238795325e-01, -9.215140393e-01, -9.191138517e-01, -9.166790599e-01,
-  -9.142097557e-01, -9.117060320e-01, -9.091679831e-01, -9.065957045e-01,
-  -9.039892931e-01, -9.013488470e-01, -8.986744657e-01, -8.959662498e-01,
-  -8.932243012e-01, -8.904487232e-01, -8.876396204e-01, -8.847970984e-01,
-  -8.819212643e-01, -8.790122264e-01, -8.760700942e-01, -8.730949784e-01,
-  -8.700869911e-01, -8.670462455e-01, -8.639728561e-01, -8.608669386e-01,
-  -8.577286100e-01, -8.545579884e-01, -8.513551931e-01, -8.481203448e-01,
-  -8.448535652e-01, -8.415549774e-01, -8.382247056e-01, -8.348628750e-01,
-  -8.314696123e-01, -8.280450453e-01, -8.245893028e-01, -8.211025150e-01,
-  -8.175848132e-01, -8.140363297e-01, -8.104571983e-01, -8.068475535e-01,
-  -8.032075315e-01, -7.995372691e-01, -7.958369046e-01, -7.921065773e-01,
-  -7.883464276e-01, -7.845565972e-01, -7.807372286e-01, -7.768884657e-01,
-  -7.730104534e-01, -7.691033376e-01, -7.651672656e-01, -7.612023855e-01,
-  -7.572088465e-01, -7.531867990e-01, -7.491363945e-01, -7.450577854e-01,
-  -7.409511254e-01, -7.368165689e-01, -7.326542717e-01, -7.284643904e-01,
-  -7.242470830e-01, -7.200025080e-01, -7.157308253e-01, -7.114321957e-01,
-  -7.071067812e-01, -7.027547445e-01, -6.983762494e-01, -6.939714609e-01,
-  -6.895405447e-01, -6.850836678e-01, -6.806009978e-01, -6.760927036e-01,
-  -6.715589548e-01, -6.669999223e-01, -6.624157776e-01, -6.578066933e-01,
-  -6.531728430e-01, -6.485144010e-01, -6.438315429e-01, -6.391244449e-01,
-  -6.343932842e-01, -6.296382389e-01, -6.248594881e-01, -6.200572118e-01,
-  -6.152315906e-01, -6.103828063e-01, -6.055110414e-01, -6.006164794e-01,
-  -5.956993045e-01, -5.907597019e-01, -5.857978575e-01, -5.808139581e-01,
-  -5.758081914e-01, -5.707807459e-01, -5.657318108e-01, -5.606615762e-01,
-  -5.555702330e-01, -5.504579729e-01, -5.453249884e-01, -5.401714727e-01,
-  -5.349976199e-01, -5.298036247e-01, -5.245896827e-01, -5.193559902e-01,
-  -5.141027442e-01, -5.088301425e-01, -5.035383837e-01, -4.982276670e-01,
-  -4.928981922e-01, -4.875501601e-01, -4.821837721e-01, -4.767992301e-01,
-  -4.713967368e-01, -4.659764958e-01, -4.605387110e-01, -4.550835871e-01,
-  -4.496113297e-01, -4.441221446e-01, -4.386162385e-01, -4.330938189e-01,
-  -4.275550934e-01, -4.220002708e-01, -4.164295601e-01, -4.108431711e-01,
-  -4.052413140e-01, -3.996241998e-01, -3.939920401e-01, -3.883450467e-01,
-  -3.826834324e-01, -3.770074102e-01, -3.713171940e-01, -3.656129978e-01,
-  -3.598950365e-01, -3.541635254e-01, -3.484186802e-01, -3.426607173e-01,
-  -3.368898534e-01, -3.311063058e-01, -3.253102922e-01, -3.195020308e-01,
-  -3.136817404e-01, -3.078496400e-01, -3.020059493e-01, -2.961508882e-01,
-  -2.902846773e-01, -2.844075372e-01, -2.785196894e-01, -2.726213554e-01,
-  -2.667127575e-01, -2.607941179e-01, -2.548656596e-01, -2.489276057e-01,
-  -2.429801799e-01, -2.370236060e-01, -2.310581083e-01, -2.250839114e-01,
-  -2.191012402e-01, -2.131103199e-01, -2.071113762e-01, -2.011046348e-01,
-  -1.950903220e-01, -1.890686641e-01, -1.830398880e-01, -1.770042204e-01,
-  -1.709618888e-01, -1.649131205e-01, -1.588581433e-01, -1.527971853e-01,
-  -1.467304745e-01, -1.406582393e-01, -1.345807085e-01, -1.284981108e-01,
-  -1.224106752e-01, -1.163186309e-01, -1.102222073e-01, -1.041216339e-01,
-  -9.801714033e-02, -9.190895650e-02, -8.579731234e-02, -7.968243797e-02,
-  -7.356456360e-02, -6.744391956e-02, -6.132073630e-02, -5.519524435e-02,
-  -4.906767433e-02, -4.293825693e-02, -3.680722294e-02, -3.067480318e-02,
-  -2.454122852e-02, -1.840672991e-02, -1.227153829e-02, -6.135884649e-03,
-  -2.449293598e-16,  6.135884649e-03,  1.227153829e-02,  1.840672991e-02,
-   2.454122852e-02,  3.067480318e-02,  3.680722294e-02,  4.293825693e-02,
-   4.906767433e-02,  5.519524435e-02,  6.132073630e-02,  6.744391956e-02,
-   7.356456360e-02,  7.968243797e-02,  8.579731234e-02,  9.190895650e-02,
-   9.801714033e-02,  1.041216339e-01,  1.102222073e-01,  1.163186309e-01,
-   1.224106752e-01,  1.284981108e-01,  1.345807085e-01,  1.406582393e-01,
-   1.467304745e-01,  1.527971853e-01,  1.588581433e-01,  1.649131205e-01,
-   1.709618888e-01,  1.770042204e-01,  1.830398880e-01,  1.890686641e-01,
-   1.950903220e-01,  2.011046348e-01,  2.071113762e-01,  2.131103199e-01,
-   2.191012402e-01,  2.250839114e-01,  2.310581083e-01,  2.370236060e-01,
-   2.429801799e-01,  2.489276057e-01,  2.548656596e-01,  2.607941179e-01,
-   2.667127575e-01,  2.726213554e-01,  2.785196894e-01,  2.844075372e-01,
-   2.902846773e-01,  2.961508882e-01,  3.020059493e-01,  3.078496400e-01,
-   3.136817404e-01,  3.195020308e-01,  3.253102922e-01,  3.311063058e-01,
-   3.368898534e-01,  3.426607173e-01,  3.484186802e-01,  3.541635254e-01,
-   3.598950365e-01,  3.656129978e-01,  3.713171940e-01,  3.770074102e-01,
-   3.826834324e-01,  3.883450467e-01,  3.939920401e-01,  3.996241998e-01,
-   4.052413140e-01,  4.108431711e-01,  4.164295601e-01,  4.220002708e-01,
-   4.275550934e-01,  4.330938189e-01,  4.386162385e-01,  4.441221446e-01,
-   4.496113297e-01,  4.550835871e-01,  4.605387110e-01,  4.659764958e-01,
-   4.713967368e-01,  4.767992301e-01,  4.821837721e-01,  4.875501601e-01,
-   4.928981922e-01,  4.982276670e-01,  5.035383837e-01,  5.088301425e-01,
-   5.141027442e-01,  5.193559902e-01,  5.245896827e-01,  5.298036247e-01,
-   5.349976199e-01,  5.401714727e-01,  5.453249884e-01,  5.504579729e-01,
-   5.555702330e-01,  5.606615762e-01,  5.657318108e-01,  5.707807459e-01,
-   5.758081914e-01,  5.808139581e-01,  5.857978575e-01,  5.907597019e-01,
-   5.956993045e-01,  6.006164794e-01,  6.055110414e-01,  6.103828063e-01,
-   6.152315906e-01,  6.200572118e-01,  6.248594881e-01,  6.296382389e-01,
-   6.343932842e-01,  6.391244449e-01,  6.438315429e-01,  6.485144010e-01,
-   6.531728430e-01,  6.578066933e-01,  6.624157776e-01,  6.669999223e-01,
-   6.715589548e-01,  6.760927036e-01,  6.806009978e-01,  6.850836678e-01,
-   6.895405447e-01,  6.939714609e-01,  6.983762494e-01,  7.027547445e-01,
-   7.071067812e-01,  7.114321957e-01,  7.157308253e-01,  7.200025080e-01,
-   7.242470830e-01,  7.284643904e-01,  7.326542717e-01,  7.368165689e-01,
-   7.409511254e-01,  7.450577854e-01,  7.491363945e-01,  7.531867990e-01,
-   7.572088465e-01,  7.612023855e-01,  7.651672656e-01,  7.691033376e-01,
-   7.730104534e-01,  7.768884657e-01,  7.807372286e-01,  7.845565972e-01,
-   7.883464276e-01,  7.921065773e-01,  7.958369046e-01,  7.995372691e-01,
-   8.032075315e-01,  8.068475535e-01,  8.104571983e-01,  8.140363297e-01,
-   8.175848132e-01,  8.211025150e-01,  8.245893028e-01,  8.280450453e-01,
-   8.314696123e-01,  8.348628750e-01,  8.382247056e-01,  8.415549774e-01,
-   8.448535652e-01,  8.481203448e-01,  8.513551931e-01,  8.545579884e-01,
-   8.577286100e-01,  8.608669386e-01,  8.639728561e-01,  8.670462455e-01,
-   8.700869911e-01,  8.730949784e-01,  8.760700942e-01,  8.790122264e-01,
-   8.819212643e-01,  8.847970984e-01,  8.876396204e-01,  8.904487232e-01,
-   8.932243012e-01,  8.959662498e-01,  8.986744657e-01,  9.013488470e-01,
-   9.039892931e-01,  9.065957045e-01,  9.091679831e-01,  9.117060320e-01,
-   9.142097557e-01,  9.166790599e-01,  9.191138517e-01,  9.215140393e-01,
-   9.238795325e-01,  9.262102421e-01,  9.285060805e-01,  9.307669611e-01,
-   9.329927988e-01,  9.351835099e-01,  9.373390119e-01,  9.394592236e-01,
-   9.415440652e-01,  9.435934582e-01,  9.456073254e-01,  9.475855910e-01,
-   9.495281806e-01,  9.514350210e-01,  9.533060404e-01,  9.551411683e-01,
-   9.569403357e-01,  9.587034749e-01,  9.604305194e-01,  9.621214043e-01,
-   9.637760658e-01,  9.653944417e-01,  9.669764710e-01,  9.685220943e-01,
-   9.700312532e-01,  9.715038910e-01,  9.729399522e-01,  9.743393828e-01,
-   9.757021300e-01,  9.770281427e-01,  9.783173707e-01,  9.795697657e-01,
-   9.807852804e-01,  9.819638691e-01,  9.831054874e-01,  9.842100924e-01,
-   9.852776424e-01,  9.863080972e-01,  9.873014182e-01,  9.882575677e-01,
-   9.891765100e-01,  9.900582103e-01,  9.909026354e-01,  9.917097537e-01,
-   9.924795346e-01,  9.932119492e-01,  9.939069700e-01,  9.945645707e-01,
-   9.951847267e-01,  9.957674145e-01,  9.963126122e-01,  9.968202993e-01,
-   9.972904567e-01,  9.977230666e-01,  9.981181129e-01,  9.984755806e-01,
-   9.987954562e-01,  9.990777278e-01,  9.993223846e-01,  9.995294175e-01,
-   9.996988187e-01,  9.998305818e-01,  9.999247018e-01,  9.999811753e-01,
-   1.000000000e+00,
-};
 const float lut_xfade_in[] = {
    0.000000000e+00,  0.000000000e+00,  0.000000000e+00,  0.000000000e+00,
    0.000000000e+00,  2.593122279e-04,  4.754021803e-03,  9.248539291e-03,
@@ -1689,72 +1366,6 @@ const float lut_midi_to_f_high[] = {
    1.250000000e-01,  1.250000000e-01,  1.250000000e-01,  1.250000000e-01,
    1.250000000e-01,  1.250000000e-01,  1.250000000e-01,  1.250000000e-01,
 };
-const float lut_midi_to_f_low[] = {
-   1.000000000e+00,  1.000225659e+00,  1.000451370e+00,  1.000677131e+00,
-   1.000902943e+00,  1.001128806e+00,  1.001354720e+00,  1.001580685e+00,
-   1.001806701e+00,  1.002032768e+00,  1.002258886e+00,  1.002485055e+00,
-   1.002711275e+00,  1.002937546e+00,  1.003163868e+00,  1.003390242e+00,
-   1.003616666e+00,  1.003843141e+00,  1.004069668e+00,  1.004296246e+00,
-   1.004522874e+00,  1.004749554e+00,  1.004976285e+00,  1.005203068e+00,
-   1.005429901e+00,  1.005656786e+00,  1.005883722e+00,  1.006110709e+00,
-   1.006337747e+00,  1.006564836e+00,  1.006791977e+00,  1.007019169e+00,
-   1.007246412e+00,  1.007473707e+00,  1.007701053e+00,  1.007928450e+00,
-   1.008155898e+00,  1.008383398e+00,  1.008610949e+00,  1.008838551e+00,
-   1.009066205e+00,  1.009293910e+00,  1.009521667e+00,  1.009749475e+00,
-   1.009977334e+00,  1.010205245e+00,  1.010433207e+00,  1.010661221e+00,
-   1.010889286e+00,  1.011117403e+00,  1.011345571e+00,  1.011573790e+00,
-   1.011802061e+00,  1.012030384e+00,  1.012258758e+00,  1.012487183e+00,
-   1.012715661e+00,  1.012944189e+00,  1.013172770e+00,  1.013401401e+00,
-   1.013630085e+00,  1.013858820e+00,  1.014087607e+00,  1.014316445e+00,
-   1.014545335e+00,  1.014774277e+00,  1.015003270e+00,  1.015232315e+00,
-   1.015461411e+00,  1.015690560e+00,  1.015919760e+00,  1.016149011e+00,
-   1.016378315e+00,  1.016607670e+00,  1.016837077e+00,  1.017066536e+00,
-   1.017296046e+00,  1.017525609e+00,  1.017755223e+00,  1.017984889e+00,
-   1.018214607e+00,  1.018444376e+00,  1.018674198e+00,  1.018904071e+00,
-   1.019133996e+00,  1.019363973e+00,  1.019594002e+00,  1.019824083e+00,
-   1.020054216e+00,  1.020284401e+00,  1.020514637e+00,  1.020744926e+00,
-   1.020975266e+00,  1.021205659e+00,  1.021436104e+00,  1.021666600e+00,
-   1.021897149e+00,  1.022127749e+00,  1.022358402e+00,  1.022589107e+00,
-   1.022819863e+00,  1.023050672e+00,  1.023281533e+00,  1.023512446e+00,
-   1.023743411e+00,  1.023974428e+00,  1.024205498e+00,  1.024436619e+00,
-   1.024667793e+00,  1.024899019e+00,  1.025130297e+00,  1.025361627e+00,
-   1.025593009e+00,  1.025824444e+00,  1.026055931e+00,  1.026287470e+00,
-   1.026519061e+00,  1.026750705e+00,  1.026982401e+00,  1.027214149e+00,
-   1.027445949e+00,  1.027677802e+00,  1.027909707e+00,  1.028141664e+00,
-   1.028373674e+00,  1.028605736e+00,  1.028837851e+00,  1.029070017e+00,
-   1.029302237e+00,  1.029534508e+00,  1.029766832e+00,  1.029999209e+00,
-   1.030231638e+00,  1.030464119e+00,  1.030696653e+00,  1.030929239e+00,
-   1.031161878e+00,  1.031394569e+00,  1.031627313e+00,  1.031860109e+00,
-   1.032092958e+00,  1.032325859e+00,  1.032558813e+00,  1.032791820e+00,
-   1.033024879e+00,  1.033257991e+00,  1.033491155e+00,  1.033724372e+00,
-   1.033957641e+00,  1.034190964e+00,  1.034424338e+00,  1.034657766e+00,
-   1.034891246e+00,  1.035124779e+00,  1.035358364e+00,  1.035592003e+00,
-   1.035825694e+00,  1.036059437e+00,  1.036293234e+00,  1.036527083e+00,
-   1.036760985e+00,  1.036994940e+00,  1.037228947e+00,  1.037463008e+00,
-   1.037697121e+00,  1.037931287e+00,  1.038165506e+00,  1.038399777e+00,
-   1.038634102e+00,  1.038868479e+00,  1.039102910e+00,  1.039337393e+00,
-   1.039571929e+00,  1.039806518e+00,  1.040041160e+00,  1.040275855e+00,
-   1.040510603e+00,  1.040745404e+00,  1.040980258e+00,  1.041215165e+00,
-   1.041450125e+00,  1.041685138e+00,  1.041920204e+00,  1.042155323e+00,
-   1.042390495e+00,  1.042625720e+00,  1.042860998e+00,  1.043096329e+00,
-   1.043331714e+00,  1.043567151e+00,  1.043802642e+00,  1.044038185e+00,
-   1.044273782e+00,  1.044509433e+00,  1.044745136e+00,  1.044980892e+00,
-   1.045216702e+00,  1.045452565e+00,  1.045688481e+00,  1.045924450e+00,
-   1.046160473e+00,  1.046396549e+00,  1.046632678e+00,  1.046868860e+00,
-   1.047105096e+00,  1.047341385e+00,  1.047577727e+00,  1.047814123e+00,
-   1.048050572e+00,  1.048287074e+00,  1.048523630e+00,  1.048760239e+00,
-   1.048996902e+00,  1.049233618e+00,  1.049470387e+00,  1.049707210e+00,
-   1.049944086e+00,  1.050181015e+00,  1.050417999e+00,  1.050655035e+00,
-   1.050892125e+00,  1.051129269e+00,  1.051366466e+00,  1.051603717e+00,
-   1.051841021e+00,  1.052078378e+00,  1.052315790e+00,  1.052553255e+00,
-   1.052790773e+00,  1.053028345e+00,  1.053265971e+00,  1.053503650e+00,
-   1.053741383e+00,  1.053979169e+00,  1.054217010e+00,  1.054454903e+00,
-   1.054692851e+00,  1.054930852e+00,  1.055168907e+00,  1.055407016e+00,
-   1.055645178e+00,  1.055883395e+00,  1.056121664e+00,  1.056359988e+00,
-   1.056598366e+00,  1.056836797e+00,  1.057075282e+00,  1.057313821e+00,
-   1.057552413e+00,  1.057791060e+00,  1.058029760e+00,  1.058268515e+00,
-   1.058507323e+00,  1.058746185e+00,  1.058985101e+00,  1.059224071e+00,
-};
 const float lut_pot_curve[] = {
    0.000000000e+00,  3.255208333e-02,  6.510416667e-02,  9.765625000e-02,
    1.056640625e-01,  1.117675781e-01,  1.178710938e-01,  1.239746094e-01,
@@ -35,6 +35,7 @@
 
 
 #include "stmlib/stmlib.h"
+#include "stmlib/resources.h"
 
 
 
@@ -68,12 +69,12 @@ extern const float fb_3520_32000[];
 extern const float fb_4435_32000[];
 extern const float fb_5588_32000[];
 extern const float fb_7040_96000[];
-extern const float lut_sin[];
+using stmlib::lut_sin;
 extern const float lut_xfade_in[];
 extern const float lut_xfade_out[];
 extern const float lut_bipolar_fold[];
 extern const float lut_midi_to_f_high[];
-extern const float lut_midi_to_f_low[];
+using stmlib::lut_midi_to_f_low;
 extern const float lut_pot_curve[];
 extern const float lut_ap_poles[];
 extern const float wav_sine_i[];
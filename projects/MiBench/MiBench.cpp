@@ -0,0 +1,927 @@
+/*
+ mi-UGens - SuperCollider UGen Library
+ Copyright (c) 2026 The mi-UGens contributors.
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see http://www.gnu.org/licenses/ .
+ */
+
+/*
+
+ MiBench - offline benchmark for the mi-UGens, no scsynth needed
+
+ The plug-ins are loaded the way scsynth loads them and get a mock
+ InterfaceTable / World. Every unit is then rendered with scripted inputs,
+ once per mode (Plaits engine, Rings model...), at several sample rates and
+ block sizes. Time per sample, worst block time and real time allocations
+ are written out as JSON.
+
+ The renders can also be saved as reference files (raw 32 bit floats, one
+ block of each output after the other) and later builds compared against
+ them, bit for bit, by maximum absolute difference or by spectral distance.
+ That's the safety net for optimizations of the DSP code.
+
+ A few checks of behaviour the renders don't cover (the MiPlaits voice pool)
+ are run as well, their results go to the "checks" of the JSON.
+
+ usage: MiBench [options] plugin...
+
+ https://vboehm.net
+
+ */
+
+
+#include "SC_PlugIn.h"
+
+#include <dlfcn.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#endif
+
+
+static InterfaceTable gInterfaceTable;
+
+struct UnitDefinition {
+    std::string name;
+    size_t      alloc_size;
+    UnitCtorFunc ctor;
+    UnitDtorFunc dtor;
+};
+
+static std::vector<UnitDefinition> gUnitDefs;
+
+struct CommandDefinition {
+    std::string name;
+    PlugInCmdFunc func;
+    void        *user_data;
+};
+
+static std::vector<CommandDefinition> gCommandDefs;
+
+struct AllocStats {
+    long        allocs;
+    long        frees;
+    size_t      bytes;
+};
+
+static AllocStats gAllocs;
+static bool gQuiet = false;
+
+
+#pragma mark ----- mock host -----
+
+static int Bench_Print(const char *fmt, ...) {
+    if(gQuiet)
+        return 0;
+    va_list args;
+    va_start(args, fmt);
+    int n = vfprintf(stderr, fmt, args);
+    va_end(args);
+    return n;
+}
+
+static bool Bench_DefineUnit(const char *name, size_t alloc_size, UnitCtorFunc ctor,
+                             UnitDtorFunc dtor, uint32 flags) {
+    UnitDefinition def = { name, alloc_size, ctor, dtor };
+    gUnitDefs.push_back(def);
+    return true;
+}
+
+static bool Bench_DefinePlugInCmd(const char *name, PlugInCmdFunc func, void *user_data) {
+    CommandDefinition def = { name, func, user_data };
+    gCommandDefs.push_back(def);
+    return true;
+}
+
+static void* Bench_RTAlloc(World *world, size_t size) {
+    ++gAllocs.allocs;
+    gAllocs.bytes += size;
+    return malloc(size);
+}
+
+static void* Bench_RTRealloc(World *world, void *ptr, size_t size) {
+    ++gAllocs.allocs;
+    if(ptr)
+        ++gAllocs.frees;
+    gAllocs.bytes += size;
+    return realloc(ptr, size);
+}
+
+static void Bench_RTFree(World *world, void *ptr) {
+    if(ptr)
+        ++gAllocs.frees;
+    free(ptr);
+}
+
+static void Bench_ClearUnitOutputs(Unit *unit, int inNumSamples) {
+    for(uint32 i=0; i<unit->mNumOutputs; ++i)
+        memset(unit->mOutBuf[i], 0, inNumSamples * sizeof(float));
+}
+
+// there is no NRT thread: the stages run right away, in order
+static int Bench_DoAsynchronousCommand(World *world, void *reply_addr, const char *name,
+                                       void *data, AsyncStageFn stage2, AsyncStageFn stage3,
+                                       AsyncStageFn stage4, AsyncFreeFn cleanup,
+                                       int completion_size, void *completion_data) {
+    if((!stage2 || stage2(world, data)) && (!stage3 || stage3(world, data)) && stage4)
+        stage4(world, data);
+    if(cleanup)
+        cleanup(world, data);
+    return 0;
+}
+
+// Runs a plug-in command with integer arguments, as /cmd would. Returns false
+// if no plug-in defines it.
+static bool Bench_RunCommand(World *world, const char *name, const std::vector<int32> &args) {
+    for(const CommandDefinition &def : gCommandDefs) {
+        if(def.name != name)
+            continue;
+        // OSC arguments: type tags padded to 4 bytes, then big endian ints
+        std::string tags = "," + std::string(args.size(), 'i');
+        std::vector<char> msg((tags.size() + 4) & ~3, 0);
+        memcpy(msg.data(), tags.data(), tags.size());
+        for(int32 arg : args) {
+            uint32 u = (uint32)arg;
+            char bytes[4] = { char(u >> 24), char(u >> 16), char(u >> 8), char(u) };
+            msg.insert(msg.end(), bytes, bytes + 4);
+        }
+        sc_msg_iter iter((int)msg.size(), msg.data());
+        (*def.func)(world, def.user_data, &iter, NULL);
+        return true;
+    }
+    return false;
+}
+
+typedef void (*LoadFunc)(InterfaceTable *);
+
+static bool Bench_LoadPlugin(const char *path) {
+    void *handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    if(!handle) {
+        fprintf(stderr, "MiBench: can't load %s: %s\n", path, dlerror());
+        return false;
+    }
+    LoadFunc load = (LoadFunc)dlsym(handle, "load");
+    if(!load) {
+        fprintf(stderr, "MiBench: %s is not a plug-in\n", path);
+        dlclose(handle);
+        return false;
+    }
+    (*load)(&gInterfaceTable);
+    return true;
+}
+
+
+#pragma mark ----- scenarios -----
+
+// A control input moved linearly from one value to another over the run.
+struct Sweep {
+    int         input;
+    float       from;
+    float       to;
+};
+
+// Inputs of a unit, in the order of its sclang class. 'audio' inputs get an
+// audio signal, 'gates' a 10 ms gate every 250 ms (after 'gate_delay'
+// seconds), 'sweeps' are updated every block, all others stay at their
+// initial value, except for the mode input which is stepped through. With
+// 'in_place', the outputs share the buffers of the audio inputs, which scsynth
+// does when no other unit reads them, and which MiVerb relies on.
+struct Scenario {
+    const char          *unit;
+    int                 num_outputs;
+    std::vector<float>  inputs;
+    std::vector<int>    audio;
+    std::vector<int>    gates;
+    std::vector<Sweep>  sweeps;
+    int                 mode_input;
+    int                 num_modes;
+    const char          *mode_name;
+    double              gate_delay;
+    bool                in_place;
+};
+
+static const Scenario kScenarios[] = {
+    { "MiBraids", 1,
+        { 60, 0.5, 0.5, 0, 0, 0, 0, 0, 0, 0 },
+        { }, { 4 }, { { 1, 0, 1 }, { 2, 1, 0 } }, 3, 48, "model" },
+    { "MiClouds", 2,
+        { 0, 0.5, 0.25, 0.4, 0.5, 0.5, 1, 0.5, 0, 0, 0, 0, 0, 0, 0, 0, -1, 0, 0 },
+        { 17, 18 }, { 13 }, { { 1, 0, 1 }, { 2, 0.1, 0.9 }, { 4, 0.2, 0.8 } }, 11, 4, "mode" },
+    { "MiElements", 2,
+        { 0, 0, 0, 48, 0.5, 0.2, 0, 0, 0, 0.5, 0.5, 0.5, 0.5, 0.5, 0.25, 0.5, 0.7, 0.2, 0.3, 0, 0, 0 },
+        { 0, 1 }, { 2 }, { { 14, 0, 1 }, { 15, 0.2, 0.8 } }, 19, 3, "model" },
+    { "MiGrids", 8,
+        { 1, 120, 0.5, 0.5, 0, 0.25, 0.25, 0.25, 0, 0, 0, 0, 0, 0, 2 },
+        { }, { }, { { 2, 0, 1 }, { 3, 1, 0 } }, 11, 2, "mode" },
+    { "MiMu", 1,
+        { 0, 1, 0 },
+        { 0 }, { }, { { 1, 0.5, 2 } }, -1, 1, NULL },
+    { "MiOmi", 2,
+        { 0, 0, 48, 0.2, 0.25, 0.5, 0.5, 0.5, 0.5, 0, 0, 0, 0, 0, 0.5, 0, 0.5, 0.5, 0.2, 0.5 },
+        { 0 }, { 1 }, { { 9, 0, 0.5 }, { 14, 0.2, 0.8 } }, -1, 1, NULL },
+    { "MiPlaits", 2,
+        { 60, 0, 0.1, 0.5, 0.5, 0, 0, 0, 0, 0, 0.5, 0.5, 0, -1 },
+        { }, { 5 }, { { 2, 0, 1 }, { 3, 1, 0 }, { 4, 0, 1 } }, 1, 24, "engine" },
+    { "MiPlaitsPoly", 2,
+        { 4, 0, 0.1, 0.5, 0.5, 0, 0, 0, 0.5, 0.5, 0, -1,
+          48, 55, 60, 67, 0, 0, 0, 0, 0, 0, 0, 0 },
+        { }, { 16, 17, 18, 19 }, { { 2, 0, 1 }, { 3, 1, 0 }, { 4, 0, 1 } }, 1, 24, "engine" },
+    { "MiRings", 2,
+        { 0, 0, 60, 0.25, 0.5, 0.7, 0.25, 0, 1, 0, 0, 0, 0 },
+        { 0 }, { 1 }, { { 3, 0, 1 }, { 4, 0.2, 0.8 }, { 6, 0, 1 } }, 7, 6, "model" },
+    { "MiRipples", 1,
+        { 0, 0.3, 0.2, 1 },
+        { 0 }, { }, { { 1, 0, 1 } }, -1, 1, NULL },
+    { "MiTides", 4,
+        { 1, 0.5, 0.5, 0.5, 0.2, 0, 0, 3, 1, 9, 1 },
+        { }, { }, { { 1, 0, 1 }, { 2, 1, 0 } }, 7, 4, "output_mode" },
+    { "MiVerb", 2,
+        { 0.7, 0.5, 0.5, 0.05, 0, 0.625, 0, 0 },
+        { 6, 7 }, { }, { { 0, 0.3, 0.9 } }, -1, 1, NULL, 0, true },
+    { "MiWarps", 2,
+        { 0, 0, 0.5, 0.5, 0, 0, 0, 110, 1, 0, 60 },
+        { 0, 1 }, { }, { { 5, 0, 1 } }, 4, 9, "algo" },
+};
+
+// --input unit:index=value
+struct InputOverride {
+    std::string unit;
+    int         input;
+    float       value;
+};
+
+static bool Bench_ParseInput(const char *arg, InputOverride *o) {
+    const char *colon = strchr(arg, ':');
+    if(!colon)
+        return false;
+    o->unit.assign(arg, colon - arg);
+    return sscanf(colon + 1, "%d=%f", &o->input, &o->value) == 2 && o->input >= 0;
+}
+
+static const Scenario* Bench_FindScenario(const std::string &name) {
+    for(const Scenario &s : kScenarios) {
+        if(name == s.unit)
+            return &s;
+    }
+    return NULL;
+}
+
+// two detuned sines and some noise, different for every input
+static void Bench_AudioSignal(float *out, int size, long pos, int index, double sr, uint32 *seed) {
+    double w1 = 2. * M_PI * (110. * (index + 1)) / sr;
+    double w2 = 2. * M_PI * (1.5 + index) / sr;
+    for(int i=0; i<size; ++i) {
+        *seed = *seed * 1664525L + 1013904223L;
+        float noise = ((*seed >> 9) * (1.f / 8388608.f)) - 0.5f;
+        long n = pos + i;
+        out[i] = 0.4f * sin(w1 * n) * (0.6f + 0.4f * sin(w2 * n)) + 0.05f * noise;
+    }
+}
+
+// 'pos' is negative before the first gate
+static void Bench_Gate(float *out, int size, long pos, int index, int num_gates, double sr) {
+    long period = (long)(0.25 * sr);
+    long width = (long)(0.01 * sr);
+    long offset = period * index / num_gates;       // polyphonic units get staggered notes
+    for(int i=0; i<size; ++i) {
+        long n = pos + i;
+        out[i] = n >= 0 && ((n + period - offset) % period) < width ? 1.f : 0.f;
+    }
+}
+
+
+#pragma mark ----- benchmark -----
+
+struct Result {
+    long        blocks;
+    double      ns_per_sample;
+    double      worst_block_ns;
+    long        ctor_allocs;
+    size_t      ctor_alloc_bytes;
+    long        allocs;
+    size_t      alloc_bytes;
+    long        leaked_allocs;
+};
+
+// 'rendered', when given, receives the outputs, block after block
+static Result Bench_Run(const UnitDefinition &def, const Scenario &scenario, int mode,
+                        double sr, int bs, double seconds, std::vector<float> *rendered) {
+    typedef std::chrono::steady_clock Clock;
+
+    int num_inputs = (int)scenario.inputs.size();
+    int num_outputs = scenario.num_outputs;
+
+    World world;
+    memset(&world, 0, sizeof(world));
+    world.mSampleRate = sr;
+    world.mBufLength = bs;
+
+    Rate &full = world.mFullRate;
+    full.mSampleRate = sr;
+    full.mSampleDur = 1. / sr;
+    full.mBufDuration = bs / sr;
+    full.mBufRate = sr / bs;
+    full.mSlopeFactor = 1. / bs;
+    full.mRadiansPerSample = 2. * M_PI / sr;
+    full.mBufLength = bs;
+    full.mFilterLoops = bs / 3;
+    full.mFilterRemain = bs % 3;
+    full.mFilterSlope = full.mFilterLoops ? 1. / full.mFilterLoops : 0.;
+
+    Rate &buf = world.mBufRate;
+    buf.mSampleRate = sr / bs;
+    buf.mSampleDur = bs / sr;
+    buf.mBufDuration = bs / sr;
+    buf.mBufRate = sr / bs;
+    buf.mSlopeFactor = 1.;
+    buf.mRadiansPerSample = 2. * M_PI * bs / sr;
+    buf.mBufLength = 1;
+    buf.mFilterLoops = 0;
+    buf.mFilterRemain = 1;
+    buf.mFilterSlope = 0.;
+
+    RGen rgen;
+    rgen.init(12345);
+    world.mRGen = &rgen;
+    world.mNumRGens = 1;
+
+    Graph graph;
+    memset(&graph, 0, sizeof(graph));
+    graph.mRGen = &rgen;
+
+    // every input gets a full buffer, even at scalar rate
+    std::vector<float> in_memory(num_inputs * bs);
+    std::vector<float> out_memory(num_outputs * bs);
+    std::vector<Wire> in_wires(num_inputs), out_wires(num_outputs);
+    std::vector<Wire*> in_wire_ptrs(num_inputs), out_wire_ptrs(num_outputs);
+    std::vector<float*> in_bufs(num_inputs), out_bufs(num_outputs);
+
+    for(int i=0; i<num_inputs; ++i) {
+        float value = scenario.inputs[i];
+        if(i == scenario.mode_input)
+            value = mode;
+        in_bufs[i] = &in_memory[i * bs];
+        std::fill(in_bufs[i], in_bufs[i] + bs, value);
+
+        Wire &wire = in_wires[i];
+        memset(&wire, 0, sizeof(wire));
+        bool audio_rate = std::count(scenario.audio.begin(), scenario.audio.end(), i)
+            || std::count(scenario.gates.begin(), scenario.gates.end(), i);
+        wire.mCalcRate = audio_rate ? calc_FullRate : calc_ScalarRate;
+        wire.mBuffer = in_bufs[i];
+        wire.mScalarValue = value;
+        in_wire_ptrs[i] = &wire;
+    }
+    for(int i=0; i<num_outputs; ++i) {
+        bool shared = scenario.in_place && i < (int)scenario.audio.size();
+        out_bufs[i] = shared ? in_bufs[scenario.audio[i]] : &out_memory[i * bs];
+        Wire &wire = out_wires[i];
+        memset(&wire, 0, sizeof(wire));
+        wire.mCalcRate = calc_FullRate;
+        wire.mBuffer = out_bufs[i];
+        out_wire_ptrs[i] = &wire;
+    }
+
+    Unit *unit = (Unit*)calloc(1, def.alloc_size);
+    unit->mWorld = &world;
+    unit->mParent = &graph;
+    unit->mNumInputs = num_inputs;
+    unit->mNumOutputs = num_outputs;
+    unit->mCalcRate = calc_FullRate;
+    unit->mInput = in_wire_ptrs.data();
+    unit->mOutput = out_wire_ptrs.data();
+    unit->mRate = &world.mFullRate;
+    unit->mBufLength = bs;
+    unit->mInBuf = in_bufs.data();
+    unit->mOutBuf = out_bufs.data();
+
+    Result result;
+    memset(&result, 0, sizeof(result));
+
+    AllocStats start = gAllocs;
+    (*def.ctor)(unit);
+    result.ctor_allocs = gAllocs.allocs - start.allocs;
+    result.ctor_alloc_bytes = gAllocs.bytes - start.bytes;
+
+    uint32 seed = 7;
+    long num_blocks = std::max(1L, (long)(seconds * sr / bs));
+    long gate_delay = (long)(scenario.gate_delay * sr);
+    double total_ns = 0.;
+    double worst_ns = 0.;
+    AllocStats before = gAllocs;
+
+    for(long b=0; b<num_blocks && unit->mCalcFunc; ++b) {
+        long pos = b * bs;
+        for(size_t k=0; k<scenario.audio.size(); ++k)
+            Bench_AudioSignal(in_bufs[scenario.audio[k]], bs, pos, (int)k, sr, &seed);
+        for(size_t k=0; k<scenario.gates.size(); ++k)
+            Bench_Gate(in_bufs[scenario.gates[k]], bs, pos - gate_delay, (int)k,
+                       (int)scenario.gates.size(), sr);
+        for(const Sweep &sweep : scenario.sweeps) {
+            float value = sweep.from + (sweep.to - sweep.from) * b / num_blocks;
+            std::fill(in_bufs[sweep.input], in_bufs[sweep.input] + bs, value);
+            in_wires[sweep.input].mScalarValue = value;
+        }
+
+        Clock::time_point t0 = Clock::now();
+        (*unit->mCalcFunc)(unit, bs);
+        Clock::time_point t1 = Clock::now();
+
+        double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+        total_ns += ns;
+        worst_ns = std::max(worst_ns, ns);
+
+        if(rendered) {
+            for(float *o : out_bufs)
+                rendered->insert(rendered->end(), o, o + bs);
+        }
+    }
+
+    result.blocks = num_blocks;
+    result.ns_per_sample = total_ns / (num_blocks * bs);
+    result.worst_block_ns = worst_ns;
+    result.allocs = gAllocs.allocs - before.allocs;
+    result.alloc_bytes = gAllocs.bytes - before.bytes;
+
+    if(def.dtor)
+        (*def.dtor)(unit);
+    free(unit);
+
+    result.leaked_allocs = (gAllocs.allocs - start.allocs) - (gAllocs.frees - start.frees);
+    return result;
+}
+
+
+#pragma mark ----- reference renders -----
+
+enum Tolerance {
+    TOLERANCE_EXACT,
+    TOLERANCE_MAX_ABS,
+    TOLERANCE_SPECTRAL
+};
+
+struct Comparison {
+    bool        found;
+    bool        bit_exact;
+    double      max_abs;
+    double      spectral_db;
+    bool        pass;
+};
+
+static const int kSpectrumSize = 1024;
+
+// power spectrum of kSpectrumSize samples (zero padded), hann window
+static void Bench_PowerSpectrum(const float *in, int size, double *power) {
+    double re[kSpectrumSize], im[kSpectrumSize];
+    for(int i=0; i<kSpectrumSize; ++i) {
+        double window = 0.5 - 0.5 * cos(2. * M_PI * i / kSpectrumSize);
+        re[i] = i < size ? in[i] * window : 0.;
+        im[i] = 0.;
+    }
+    // in place radix-2 fft
+    for(int i=1, j=0; i<kSpectrumSize; ++i) {
+        int bit = kSpectrumSize >> 1;
+        for(; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+        if(i < j) {
+            std::swap(re[i], re[j]);
+            std::swap(im[i], im[j]);
+        }
+    }
+    for(int len=2; len<=kSpectrumSize; len <<= 1) {
+        double w = -2. * M_PI / len;
+        for(int i=0; i<kSpectrumSize; i+=len) {
+            for(int k=0; k<len/2; ++k) {
+                double c = cos(w * k), s = sin(w * k);
+                int a = i + k, b = i + k + len/2;
+                double tr = re[b] * c - im[b] * s;
+                double ti = re[b] * s + im[b] * c;
+                re[b] = re[a] - tr;
+                im[b] = im[a] - ti;
+                re[a] += tr;
+                im[a] += ti;
+            }
+        }
+    }
+    for(int i=0; i<=kSpectrumSize/2; ++i)
+        power[i] = re[i] * re[i] + im[i] * im[i];
+}
+
+// log spectral distance in dB, averaged over half overlapping frames, of the
+// worst output
+static double Bench_SpectralDistance(const std::vector<float> &a, const std::vector<float> &b,
+                                     int num_outputs, int bs) {
+    const double floor = 1e-6;                     // about -110 dB for a full scale sine
+    long num_samples = (long)a.size() / num_outputs;
+    std::vector<float> xa(num_samples), xb(num_samples);
+    double power_a[kSpectrumSize/2 + 1], power_b[kSpectrumSize/2 + 1];
+    double worst = 0.;
+
+    for(int ch=0; ch<num_outputs; ++ch) {
+        for(long i=0; i<num_samples; ++i) {
+            long index = (i / bs) * bs * num_outputs + ch * bs + i % bs;
+            xa[i] = a[index];
+            xb[i] = b[index];
+        }
+        double sum = 0.;
+        int frames = 0;
+        for(long pos=0; pos==0 || pos + kSpectrumSize <= num_samples; pos += kSpectrumSize/2) {
+            int size = (int)std::min<long>(kSpectrumSize, num_samples - pos);
+            Bench_PowerSpectrum(&xa[pos], size, power_a);
+            Bench_PowerSpectrum(&xb[pos], size, power_b);
+            double d = 0.;
+            for(int k=0; k<=kSpectrumSize/2; ++k) {
+                double db = 10. * log10((power_a[k] + floor) / (power_b[k] + floor));
+                d += db * db;
+            }
+            sum += sqrt(d / (kSpectrumSize/2 + 1));
+            ++frames;
+        }
+        worst = std::max(worst, sum / frames);
+    }
+    return worst;
+}
+
+static std::string Bench_ReferencePath(const std::string &dir, const std::string &unit,
+                                       int mode, double sr, int bs) {
+    char name[256];
+    snprintf(name, sizeof(name), "/%s_%d_%g_%d.f32", unit.c_str(), mode, sr, bs);
+    return dir + name;
+}
+
+static bool Bench_WriteReference(const std::string &path, const std::vector<float> &rendered) {
+    FILE *f = fopen(path.c_str(), "wb");
+    if(!f) {
+        fprintf(stderr, "MiBench: can't write %s\n", path.c_str());
+        return false;
+    }
+    fwrite(rendered.data(), sizeof(float), rendered.size(), f);
+    fclose(f);
+    return true;
+}
+
+static Comparison Bench_Compare(const std::string &path, const std::vector<float> &rendered,
+                                int num_outputs, int bs, Tolerance tolerance, double limit) {
+    Comparison c;
+    memset(&c, 0, sizeof(c));
+
+    std::vector<float> reference(rendered.size());
+    FILE *f = fopen(path.c_str(), "rb");
+    if(!f)
+        return c;
+    size_t n = fread(reference.data(), sizeof(float), reference.size(), f);
+    bool longer = fgetc(f) != EOF;
+    fclose(f);
+    if(n != rendered.size() || longer)              // rendered with other settings
+        return c;
+    c.found = true;
+
+    c.bit_exact = !memcmp(reference.data(), rendered.data(), n * sizeof(float));
+    for(size_t i=0; i<n; ++i) {
+        double d = fabs((double)reference[i] - rendered[i]);
+        if(!(d <= c.max_abs) && !std::isnan(c.max_abs))      // a NaN sticks
+            c.max_abs = d;
+    }
+    c.spectral_db = c.bit_exact ? 0. : Bench_SpectralDistance(reference, rendered, num_outputs, bs);
+
+    switch(tolerance) {
+        case TOLERANCE_EXACT: c.pass = c.bit_exact; break;
+        case TOLERANCE_MAX_ABS: c.pass = c.max_abs <= limit; break;
+        case TOLERANCE_SPECTRAL: c.pass = c.spectral_db <= limit; break;
+    }
+    return c;
+}
+
+// NaNs are not valid JSON
+static void Bench_PrintNumber(FILE *out, const char *key, double value) {
+    if(std::isnan(value))
+        fprintf(out, "\"%s\": null, ", key);
+    else
+        fprintf(out, "\"%s\": %g, ", key, value);
+}
+
+static bool Bench_ParseTolerance(const char *arg, Tolerance *tolerance, double *limit) {
+    std::string s = arg;
+    size_t colon = s.find(':');
+    std::string kind = s.substr(0, colon);
+    *limit = colon == std::string::npos ? 0. : atof(s.c_str() + colon + 1);
+    if(kind == "exact")
+        *tolerance = TOLERANCE_EXACT;
+    else if(kind == "max-abs" && colon != std::string::npos)
+        *tolerance = TOLERANCE_MAX_ABS;
+    else if(kind == "spectral" && colon != std::string::npos)
+        *tolerance = TOLERANCE_SPECTRAL;
+    else
+        return false;
+    return true;
+}
+
+
+#pragma mark ----- checks -----
+
+// Behaviour the renders don't cover. Each check writes one JSON object per
+// case and returns the number of failed cases.
+
+static const double kSilence = 1e-6;      // -120 dB
+
+// A MiPlaits voice taken from the pool must start like a new one. Each engine
+// is played on the single voice of a pool, then a second synth takes the voice
+// over, with its first trigger after 'delay': until then, it has to render
+// what a new voice renders (silence, for most engines).
+static int Bench_CheckVoicePool(FILE *out, bool *first) {
+    const UnitDefinition *def = NULL;
+    for(const UnitDefinition &d : gUnitDefs) {
+        if(d.name == "MiPlaits")
+            def = &d;
+    }
+    const Scenario *scenario = Bench_FindScenario("MiPlaits");
+    if(!def || !scenario)
+        return 0;
+
+    const double sr = 48000.;
+    const int bs = 64;
+    const double delay = 0.25;
+
+    World world;
+    memset(&world, 0, sizeof(world));
+    world.mSampleRate = sr;
+    world.mBufLength = bs;
+    if(!Bench_RunCommand(&world, "miPlaitsPool", { 0 }))
+        return 0;
+
+    Scenario later = *scenario;
+    later.gate_delay = delay;
+
+    int failures = 0;
+    for(int engine=0; engine<scenario->num_modes; ++engine) {
+        std::vector<float> fresh, pooled;
+        Bench_RunCommand(&world, "miPlaitsPool", { 0 });
+        Bench_Run(*def, later, engine, sr, bs, delay, &fresh);
+        Bench_RunCommand(&world, "miPlaitsPool", { 1 });
+        Bench_Run(*def, *scenario, engine, sr, bs, 0.5, NULL);
+        Bench_Run(*def, later, engine, sr, bs, delay, &pooled);
+
+        double max_abs = 0.;
+        double peak = 0.;
+        for(size_t i=0; i<pooled.size() && i<fresh.size(); ++i) {
+            max_abs = std::max(max_abs, (double)fabs(pooled[i] - fresh[i]));
+            peak = std::max(peak, (double)fabs(pooled[i]));
+        }
+        bool pass = pooled.size() == fresh.size() && max_abs <= kSilence;
+
+        fprintf(out, "%s\n    {\"check\": \"voice_pool\", \"unit\": \"MiPlaits\", "
+                "\"engine\": %d, ", *first ? "" : ",", engine);
+        Bench_PrintNumber(out, "peak_before_trigger", peak);
+        Bench_PrintNumber(out, "max_abs", max_abs);
+        fprintf(out, "\"pass\": %s}", pass ? "true" : "false");
+        *first = false;
+        if(!pass) {
+            fprintf(stderr, "MiBench: MiPlaits engine %d, a pooled voice plays what it "
+                    "played before (%g off before the first trigger)\n", engine, max_abs);
+            ++failures;
+        }
+    }
+    Bench_RunCommand(&world, "miPlaitsPool", { 0 });
+    return failures;
+}
+
+
+#pragma mark ----- main -----
+
+static std::vector<double> Bench_ParseList(const char *arg) {
+    std::vector<double> values;
+    const char *p = arg;
+    while(*p) {
+        char *end;
+        double value = strtod(p, &end);
+        if(end == p)
+            break;
+        values.push_back(value);
+        p = *end == ',' ? end + 1 : end;
+    }
+    return values;
+}
+
+static void Bench_Usage() {
+    fprintf(stderr,
+            "usage: MiBench [options] plugin...\n"
+            "  --sample-rates list   sample rates, default 44100,48000,96000\n"
+            "  --block-sizes list    block sizes, default 32,64,128\n"
+            "  --seconds s           audio rendered per run, default 1\n"
+            "  --unit name           only benchmark this unit (repeatable)\n"
+            "  --input unit:i=value  set input i of the unit to value, a mode input\n"
+            "                        then runs this mode only (repeatable)\n"
+            "  --output file         write the JSON there instead of stdout\n"
+            "  --quiet               hide what the plug-ins print\n"
+            "  --reference dir       save the renders in dir\n"
+            "  --compare dir         compare the renders with the ones saved in dir\n"
+            "  --tolerance t         exact (default), max-abs:<difference> or\n"
+            "                        spectral:<log spectral distance in dB>\n");
+}
+
+int main(int argc, char *argv[]) {
+    std::vector<double> sample_rates = { 44100, 48000, 96000 };
+    std::vector<double> block_sizes = { 32, 64, 128 };
+    std::vector<std::string> only_units;
+    std::vector<InputOverride> overrides;
+    double seconds = 1.;
+    const char *output_path = NULL;
+    const char *reference_dir = NULL;
+    const char *compare_dir = NULL;
+    Tolerance tolerance = TOLERANCE_EXACT;
+    double limit = 0.;
+    std::vector<const char*> plugins;
+
+    for(int i=1; i<argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if(arg == "--sample-rates" && has_value)
+            sample_rates = Bench_ParseList(argv[++i]);
+        else if(arg == "--block-sizes" && has_value)
+            block_sizes = Bench_ParseList(argv[++i]);
+        else if(arg == "--seconds" && has_value)
+            seconds = atof(argv[++i]);
+        else if(arg == "--unit" && has_value)
+            only_units.push_back(argv[++i]);
+        else if(arg == "--input" && has_value) {
+            InputOverride o;
+            if(!Bench_ParseInput(argv[++i], &o)) {
+                Bench_Usage();
+                return 1;
+            }
+            overrides.push_back(o);
+        }
+        else if(arg == "--output" && has_value)
+            output_path = argv[++i];
+        else if(arg == "--quiet")
+            gQuiet = true;
+        else if(arg == "--reference" && has_value)
+            reference_dir = argv[++i];
+        else if(arg == "--compare" && has_value)
+            compare_dir = argv[++i];
+        else if(arg == "--tolerance" && has_value) {
+            if(!Bench_ParseTolerance(argv[++i], &tolerance, &limit)) {
+                Bench_Usage();
+                return 1;
+            }
+        }
+        else if(arg.compare(0, 2, "--") == 0) {
+            Bench_Usage();
+            return 1;
+        }
+        else
+            plugins.push_back(argv[i]);
+    }
+    if(plugins.empty() || sample_rates.empty() || block_sizes.empty()) {
+        Bench_Usage();
+        return 1;
+    }
+
+    gInterfaceTable.fPrint = Bench_Print;
+    gInterfaceTable.fDefineUnit = Bench_DefineUnit;
+    gInterfaceTable.fDefinePlugInCmd = Bench_DefinePlugInCmd;
+    gInterfaceTable.fClearUnitOutputs = Bench_ClearUnitOutputs;
+    gInterfaceTable.fRTAlloc = Bench_RTAlloc;
+    gInterfaceTable.fRTRealloc = Bench_RTRealloc;
+    gInterfaceTable.fRTFree = Bench_RTFree;
+    gInterfaceTable.fDoAsynchronousCommand = Bench_DoAsynchronousCommand;
+
+    for(const char *path : plugins)
+        Bench_LoadPlugin(path);
+
+#if defined(__SSE__) || defined(_M_X64)
+    // flush denormals to zero, as scsynth does
+    _mm_setcsr(_mm_getcsr() | 0x8040);
+#endif
+
+    if(reference_dir)
+        mkdir(reference_dir, 0755);
+
+    FILE *out = output_path ? fopen(output_path, "w") : stdout;
+    if(!out) {
+        fprintf(stderr, "MiBench: can't write %s\n", output_path);
+        return 1;
+    }
+
+    fprintf(out, "{\n  \"benchmark\": \"MiBench\",\n  \"seconds\": %g,\n  \"runs\": [", seconds);
+    bool first = true;
+    int failures = 0;
+
+    for(const UnitDefinition &def : gUnitDefs) {
+        if(!only_units.empty() &&
+           std::find(only_units.begin(), only_units.end(), def.name) == only_units.end())
+            continue;
+        const Scenario *found = Bench_FindScenario(def.name);
+        if(!found) {
+            fprintf(stderr, "MiBench: no scenario for %s, skipped\n", def.name.c_str());
+            continue;
+        }
+        fprintf(stderr, "MiBench: %s\n", def.name.c_str());
+
+        Scenario modified = *found;
+        const Scenario *scenario = &modified;
+        int first_mode = 0;
+        int num_modes = scenario->num_modes;
+        for(const InputOverride &o : overrides) {
+            if(o.unit != def.name)
+                continue;
+            if(o.input >= (int)modified.inputs.size()) {
+                fprintf(stderr, "MiBench: %s has no input %d\n", def.name.c_str(), o.input);
+                continue;
+            }
+            modified.inputs[o.input] = o.value;
+            if(o.input == modified.mode_input) {
+                first_mode = (int)o.value;
+                num_modes = 1;
+            }
+        }
+
+        for(int mode=first_mode; mode<first_mode+num_modes; ++mode) {
+            for(double sr : sample_rates) {
+                for(double bs : block_sizes) {
+                    std::vector<float> rendered;
+                    bool keep = reference_dir || compare_dir;
+                    Result r = Bench_Run(def, *scenario, mode, sr, (int)bs, seconds,
+                                         keep ? &rendered : NULL);
+
+                    fprintf(out, "%s\n    {\"unit\": \"%s\", ", first ? "" : ",", def.name.c_str());
+                    if(scenario->mode_name)
+                        fprintf(out, "\"mode_input\": \"%s\", ", scenario->mode_name);
+                    else
+                        fprintf(out, "\"mode_input\": null, ");
+                    fprintf(out, "\"mode\": %d, \"sample_rate\": %g, \"block_size\": %d, "
+                            "\"blocks\": %ld, \"ns_per_sample\": %.3f, \"worst_block_ns\": %.0f, "
+                            "\"cpu_load\": %.6f, \"ctor_allocs\": %ld, \"ctor_alloc_bytes\": %zu, "
+                            "\"allocs\": %ld, \"alloc_bytes\": %zu, \"leaked_allocs\": %ld",
+                            mode, sr, (int)bs, r.blocks, r.ns_per_sample, r.worst_block_ns,
+                            r.ns_per_sample * sr * 1e-9, r.ctor_allocs, r.ctor_alloc_bytes,
+                            r.allocs, r.alloc_bytes, r.leaked_allocs);
+
+                    if(reference_dir) {
+                        std::string path = Bench_ReferencePath(reference_dir, def.name, mode, sr, (int)bs);
+                        if(!Bench_WriteReference(path, rendered))
+                            ++failures;
+                    }
+                    if(compare_dir) {
+                        std::string path = Bench_ReferencePath(compare_dir, def.name, mode, sr, (int)bs);
+                        Comparison c = Bench_Compare(path, rendered, scenario->num_outputs,
+                                                     (int)bs, tolerance, limit);
+                        if(c.found) {
+                            fprintf(out, ", \"reference\": {\"bit_exact\": %s, ", c.bit_exact ? "true" : "false");
+                            Bench_PrintNumber(out, "max_abs", c.max_abs);
+                            Bench_PrintNumber(out, "spectral_db", c.spectral_db);
+                            fprintf(out, "\"pass\": %s}", c.pass ? "true" : "false");
+                        }
+                        else
+                            fprintf(out, ", \"reference\": {\"pass\": false, \"missing\": true}");
+                        if(!c.pass) {
+                            fprintf(stderr, "MiBench: %s mode %d, %g Hz, block size %d: %s\n",
+                                    def.name.c_str(), mode, sr, (int)bs,
+                                    c.found ? "differs from the reference" : "no matching reference");
+                            ++failures;
+                        }
+                    }
+                    fprintf(out, "}");
+                    first = false;
+                }
+            }
+        }
+    }
+
+    fprintf(out, "\n  ],\n  \"checks\": [");
+    first = true;
+    if(only_units.empty() ||
+       std::find(only_units.begin(), only_units.end(), "MiPlaits") != only_units.end())
+        failures += Bench_CheckVoicePool(out, &first);
+
+    fprintf(out, "\n  ]\n}\n");
+    if(out != stdout)
+        fclose(out);
+
+    if(failures)
+        fprintf(stderr, "MiBench: %d failed run(s) or check(s)\n", failures);
+    return failures ? 2 : 0;
+}
@@ -34,13 +34,16 @@
 
 #include "SC_PlugIn.h"
 
+#include "stmlib/dsp/sample_rate_converter.h"
 #include "stmlib/utils/dsp.h"
+#include "stmlib/utils/random.h"
 
 #include "braids/envelope.h"
 #include "braids/macro_oscillator.h"
 #include "braids/quantizer.h"
 #include "braids/signature_waveshaper.h"
 #include "braids/quantizer_scales.h"
+#include "braids/sample_rate_conversion_filters.h"
 #include "braids/vco_jitter_source.h"
 
 
@@ -50,6 +53,8 @@
 
 #include "samplerate.h"
 
+#include <new>
+
 
 #define     MI_SAMPLERATE       96000.f
 #define     BLOCK_SIZE          32      // --> macro_oscillator.h !
@@ -69,6 +74,10 @@ const uint16_t bit_reduction_masks[] = {
 
 static InterfaceTable *ft;
 
+#include "MiProfile.h"     // needs ft
+
+MI_PROFILER(gProfiler, "MiBraids", "shape", braids::MACRO_OSC_SHAPE_LAST);
+
 
 typedef struct
 {
@@ -81,6 +90,9 @@ typedef struct
 } PROCESS_CB_DATA ;
 
 
+struct SrcCommand;
+
+
 struct MiBraids : public Unit {
     
     //braids::VcoJitterSource jitter_source;
@@ -90,15 +102,24 @@ struct MiBraids : public Unit {
     bool            last_trig;
     
     // resampler
-    SRC_STATE       *src_state;
+    int             decimation;     // oversampling factor, 0: libsamplerate
+    void            *decimator;
+    SRC_STATE       *src_state;     // NULL until built by the NRT thread
+    SrcCommand      *src_command;   // pending creation of src_state
     PROCESS_CB_DATA pd;
     float           *samples;
     float           ratio;
+    
+    uint32_t        rng_state;
 };
 
 
 
 static long src_input_callback(void *cb_data, float **audio);
+static void MiBraids_RenderBlock(PROCESS_CB_DATA *data, float *out);
+
+static void MiBraids_InitSrc(MiBraids *unit);
+static void MiBraids_FreeSrc(MiBraids *unit);
 
 static void MiBraids_Ctor(MiBraids *unit);
 static void MiBraids_Dtor(MiBraids *unit);
@@ -108,30 +129,184 @@ static void MiBraids_next_resamp(MiBraids *unit, int inNumSamples);
 
 
 
+#pragma mark ----- resampler -----
+
+// libsamplerate mallocs its converter state, so it is created and deleted on
+// the NRT thread. The unit outputs silence until the converter has arrived.
+
+struct SrcCommand {
+    MiBraids        *unit;      // NULL once the unit has been freed
+    PROCESS_CB_DATA *pd;
+    SRC_STATE       *state;
+};
+
+
+static bool MiBraids_CreateSrc(World *world, void *data) {     // NRT
+    SrcCommand *cmd = (SrcCommand*)data;
+    int error;
+    cmd->state = src_callback_new(src_input_callback, SRC_SINC_FASTEST, 1, &error, cmd->pd);
+    if(cmd->state == NULL)
+        Print("MiBraids ERROR: src_callback_new() failed : %s.\n", src_strerror(error));
+    return true;
+}
+
+static bool MiBraids_InstallSrc(World *world, void *data) {    // RT
+    SrcCommand *cmd = (SrcCommand*)data;
+    if(cmd->unit) {
+        cmd->unit->src_state = cmd->state;
+        cmd->unit->src_command = NULL;
+        cmd->state = NULL;
+    }
+    return true;
+}
+
+static bool MiBraids_DeleteSrc(World *world, void *data) {     // NRT
+    SrcCommand *cmd = (SrcCommand*)data;
+    if(cmd->state)
+        src_delete(cmd->state);
+    return false;
+}
+
+static void MiBraids_FreeSrcCommand(World *world, void *data) { // RT
+    RTFree(world, data);
+}
+
+
+static void MiBraids_InitSrc(MiBraids *unit) {
+    SrcCommand *cmd = (SrcCommand*)RTAlloc(unit->mWorld, sizeof(SrcCommand));
+    if(cmd == NULL) {
+        Print("MiBraids ERROR: mem alloc failed!\n");
+        return;
+    }
+    cmd->unit = unit;
+    cmd->pd = &unit->pd;
+    cmd->state = NULL;
+    unit->src_command = cmd;
+    DoAsynchronousCommand(unit->mWorld, 0, 0, cmd,
+                          MiBraids_CreateSrc, MiBraids_InstallSrc, MiBraids_DeleteSrc,
+                          MiBraids_FreeSrcCommand, 0, 0);
+}
+
+static void MiBraids_FreeSrc(MiBraids *unit) {
+    if(unit->src_command) {
+        // still on its way, it will be deleted on arrival
+        unit->src_command->unit = NULL;
+    }
+    if(unit->src_state) {
+        SrcCommand *cmd = (SrcCommand*)RTAlloc(unit->mWorld, sizeof(SrcCommand));
+        if(cmd == NULL) {
+            Print("MiBraids ERROR: mem alloc failed, leaking resampler!\n");
+            return;
+        }
+        cmd->unit = NULL;
+        cmd->pd = NULL;
+        cmd->state = unit->src_state;
+        DoAsynchronousCommand(unit->mWorld, 0, 0, cmd,
+                              MiBraids_DeleteSrc, 0, 0,
+                              MiBraids_FreeSrcCommand, 0, 0);
+    }
+}
+
+
+#pragma mark ----- decimator -----
+
+// If an integer multiple of the server rate is close enough to 96kHz, the
+// oscillator runs at that rate and a fixed polyphase filter brings it down.
+// libsamplerate is only used for the other rates.
+
+const int kMaxDecimation = 4;
+
+template<int32_t ratio> struct Decimator { };
+template<> struct Decimator<2> { typedef stmlib::SampleRateConverter<stmlib::SRC_DOWN, 2, 48> SRC; };
+template<> struct Decimator<3> { typedef stmlib::SampleRateConverter<stmlib::SRC_DOWN, 3, 72> SRC; };
+template<> struct Decimator<4> { typedef stmlib::SampleRateConverter<stmlib::SRC_DOWN, 4, 96> SRC; };
+
+
+static int MiBraids_DecimationFactor(float sr) {
+    int factor = (int)(MI_SAMPLERATE / sr + 0.5f);
+    if(factor < 1 || factor > kMaxDecimation || fabsf(sr * factor - MI_SAMPLERATE) > 0.1f * MI_SAMPLERATE)
+        return 0;
+    return factor;
+}
+
+template<int32_t ratio>
+static bool MiBraids_InitDecimator(MiBraids *unit) {
+    typedef typename Decimator<ratio>::SRC SRC;
+    SRC *src = (SRC*)RTAlloc(unit->mWorld, sizeof(SRC));
+    if(src == NULL)
+        return false;
+    new(src) SRC;
+    src->Init();
+    unit->decimator = src;
+    return true;
+}
+
+template<int32_t ratio>
+static void MiBraids_Decimate(MiBraids *unit, float *out, int inNumSamples) {
+    typedef typename Decimator<ratio>::SRC SRC;
+    SRC *src = static_cast<SRC*>(unit->decimator);
+    float *samples = unit->samples;
+    
+    for(int count = 0; count < inNumSamples; count += BLOCK_SIZE) {
+        for(int i = 0; i < ratio; ++i)
+            MiBraids_RenderBlock(&unit->pd, samples + i * BLOCK_SIZE);
+        src->Process(samples, out + count, ratio * BLOCK_SIZE);
+    }
+}
+
+
+#pragma mark ----- ctor/dtor -----
+
 static void MiBraids_Ctor(MiBraids *unit) {
 
+    unit->pd.osc = NULL;
+    unit->ws = NULL;
+    unit->quantizer = NULL;
+    unit->samples = NULL;
+    unit->decimation = 0;
+    unit->decimator = NULL;
+    unit->src_state = NULL;
+    unit->src_command = NULL;
+    
     unit->ratio = SAMPLERATE / MI_SAMPLERATE;
     //Print("sr ratio: %f\n", unit->ratio);
     
     if (BUFLENGTH < BLOCK_SIZE) {
         Print("MiBraids error: block size can't be smaller than %d samples!\n", BLOCK_SIZE);
-        unit = NULL;
+        SETCALC(ClearUnitOutputs);
+        ClearUnitOutputs(unit, 1);
         return;
     }
         
     
-    unit->pd.osc = new braids::MacroOscillator;
+    uint32_t seed = unit->mNumInputs > 9 ? static_cast<int32_t>(IN0(9)) : 0;
+    unit->rng_state = seed ? seed : unit->mParent->mRGen->trand();
+    stmlib::ScopedRandomState rng(&unit->rng_state);
+    
+    unit->pd.osc = (braids::MacroOscillator*)RTAlloc(unit->mWorld, sizeof(braids::MacroOscillator));
+    unit->ws = (braids::SignatureWaveshaper*)RTAlloc(unit->mWorld, sizeof(braids::SignatureWaveshaper));
+    unit->quantizer = (braids::Quantizer*)RTAlloc(unit->mWorld, sizeof(braids::Quantizer));
+    unit->samples = (float *)RTAlloc(unit->mWorld, 1024 * sizeof(float));
+    
+    if(unit->pd.osc == NULL || unit->ws == NULL || unit->quantizer == NULL || unit->samples == NULL) {
+        Print("MiBraids ERROR: mem alloc failed!\n");
+        SETCALC(ClearUnitOutputs);
+        ClearUnitOutputs(unit, 1);
+        return;
+    }
+    
     memset(unit->pd.osc, 0, sizeof(*unit->pd.osc));
+    new(unit->pd.osc) braids::MacroOscillator;
     
     unit->pd.osc->Init(SAMPLERATE);
     unit->pd.osc->set_pitch((48 << 7));
     unit->pd.osc->set_shape(braids::MACRO_OSC_SHAPE_VOWEL_FOF);
 
     
-    unit->ws = new braids::SignatureWaveshaper;
+    new(unit->ws) braids::SignatureWaveshaper;
     unit->ws->Init(123774);
     
-    unit->quantizer = new braids::Quantizer;
+    new(unit->quantizer) braids::Quantizer;
     unit->quantizer->Init();
     unit->quantizer->Configure(braids::scales[0]);
     
@@ -143,23 +318,6 @@ static void MiBraids_Ctor(MiBraids *unit) {
     
     unit->last_trig = false;
     
-    // setup SRC ----------------
-    int error;
-    int converter = SRC_SINC_FASTEST;       //SRC_SINC_MEDIUM_QUALITY;
-    
-    
-    // Initialize the sample rate converter
-    
-    if((unit->src_state = src_callback_new(src_input_callback, converter, 1, &error, &unit->pd)) == NULL)
-    {
-        Print("\n\n MiBraids ERROR: src_new() failed : %s.\n\n", src_strerror (error)) ;
-        unit = NULL;
-        return;
-    }
-    
-    unit->samples = (float *)RTAlloc(unit->mWorld, 1024 * sizeof(float));
-    
-    
     // check resample flag
     int resamp = (int)IN0(5);
     CONSTRAIN(resamp, 0, 2);
@@ -168,11 +326,29 @@ static void MiBraids_Ctor(MiBraids *unit) {
             SETCALC(MiBraids_next);
             //Print("resamp: OFF\n");
             break;
-        case 1:
-            unit->pd.osc->Init(MI_SAMPLERATE);
+        case 1: {
+            bool ok = true;
+            unit->decimation = MiBraids_DecimationFactor(SAMPLERATE);
+            switch(unit->decimation) {
+                case 0:
+                    MiBraids_InitSrc(unit);     // SRC_SINC_FASTEST
+                    break;
+                case 2: ok = MiBraids_InitDecimator<2>(unit); break;
+                case 3: ok = MiBraids_InitDecimator<3>(unit); break;
+                case 4: ok = MiBraids_InitDecimator<4>(unit); break;
+            }
+            if(!ok) {
+                Print("MiBraids ERROR: mem alloc failed!\n");
+                SETCALC(ClearUnitOutputs);
+                ClearUnitOutputs(unit, 1);
+                return;
+            }
+            float internal_sr = unit->decimation ? SAMPLERATE * unit->decimation : MI_SAMPLERATE;
+            unit->pd.osc->Init(internal_sr);
             SETCALC(MiBraids_next_resamp);
-            Print("MiBraids: internal sr: 96kHz - resamp: ON\n");
+            Print("MiBraids: internal sr: %gkHz - resamp: ON\n", internal_sr * 0.001f);
             break;
+        }
         case 2:
             SETCALC(MiBraids_next_reduc);
             Print("MiBraids: resamp: OFF, reduction: ON\n");
@@ -186,14 +362,25 @@ static void MiBraids_Ctor(MiBraids *unit) {
 
 
 static void MiBraids_Dtor(MiBraids *unit) {
-    delete unit->pd.osc;
-    delete unit->ws;
-    delete unit->quantizer;
+    if(unit->pd.osc) {
+        unit->pd.osc->~MacroOscillator();
+        RTFree(unit->mWorld, unit->pd.osc);
+    }
+    if(unit->ws) {
+        unit->ws->~SignatureWaveshaper();
+        RTFree(unit->mWorld, unit->ws);
+    }
+    if(unit->quantizer) {
+        unit->quantizer->~Quantizer();
+        RTFree(unit->mWorld, unit->quantizer);
+    }
     if(unit->samples) {
         RTFree(unit->mWorld, unit->samples);
     }
-    if(unit->src_state)
-        src_delete(unit->src_state);
+    if(unit->decimator) {
+        RTFree(unit->mWorld, unit->decimator);     // trivially destructible
+    }
+    MiBraids_FreeSrc(unit);
 }
 
 
@@ -201,6 +388,8 @@ static void MiBraids_Dtor(MiBraids *unit) {
 
 void MiBraids_next( MiBraids *unit, int inNumSamples)
 {
+    stmlib::ScopedRandomState rng(&unit->rng_state);
+    
     float   voct_in = IN0(0);
     float   timbre_in = IN0(1);
     float   color_in = IN0(2);
@@ -266,7 +455,10 @@ void MiBraids_next( MiBraids *unit, int inNumSamples)
     
     for(int count = 0; count < inNumSamples; count += size) {
         // render
-        osc->Render(sync_buffer, buffer, size);
+        {
+            MI_PROFILE_SCOPE(gProfiler, osc->shape(), size);
+            osc->Render(sync_buffer, buffer, size);
+        }
         
         for (int i = 0; i < size; ++i) {
             out[count + i] = buffer[i] * SAMP_SCALE;
@@ -278,6 +470,8 @@ void MiBraids_next( MiBraids *unit, int inNumSamples)
 
 void MiBraids_next_resamp( MiBraids *unit, int inNumSamples)
 {
+    stmlib::ScopedRandomState rng(&unit->rng_state);
+    
     float voct_in = IN0(0);
     float timbre_in = IN0(1);
     float color_in = IN0(2);
@@ -292,10 +486,13 @@ void MiBraids_next_resamp( MiBraids *unit, int inNumSamples)
     //braids::VcoJitterSource *jitter_source = &unit->jitter_source;
     SRC_STATE   *src_state = unit->src_state;
     
-    float       *samples, *output;
-    float       ratio = unit->ratio;
+    if(unit->decimation == 0 && src_state == NULL) {     // resampler not there yet
+        ClearUnitOutputs(unit, inNumSamples);
+        return;
+    }
     
-    samples = unit->samples;
+    float       *output;
+    float       ratio = unit->ratio;
     
     CONSTRAIN(voct_in, 0.f, 127.f);
     int pit = (int)voct_in;
@@ -344,11 +541,22 @@ void MiBraids_next_resamp( MiBraids *unit, int inNumSamples)
     }
     
     
-    for(int count = 0; count < inNumSamples; count += BLOCK_SIZE) {
-        output = out + count;
-        
-        // render
-        src_callback_read(src_state, ratio, BLOCK_SIZE, output);
+    switch(unit->decimation) {
+        case 0:
+            for(int count = 0; count < inNumSamples; count += BLOCK_SIZE) {
+                output = out + count;
+                
+                // render
+                src_callback_read(src_state, ratio, BLOCK_SIZE, output);
+            }
+            break;
+        case 1:
+            for(int count = 0; count < inNumSamples; count += BLOCK_SIZE)
+                MiBraids_RenderBlock(&unit->pd, out + count);
+            break;
+        case 2: MiBraids_Decimate<2>(unit, out, inNumSamples); break;
+        case 3: MiBraids_Decimate<3>(unit, out, inNumSamples); break;
+        case 4: MiBraids_Decimate<4>(unit, out, inNumSamples); break;
     }
     
 }
@@ -357,6 +565,8 @@ void MiBraids_next_resamp( MiBraids *unit, int inNumSamples)
 
 void MiBraids_next_reduc( MiBraids *unit, int inNumSamples)
 {
+    stmlib::ScopedRandomState rng(&unit->rng_state);
+    
     float   voct_in = IN0(0);
     float   timbre_in = IN0(1);
     float   color_in = IN0(2);
@@ -438,7 +648,10 @@ void MiBraids_next_reduc( MiBraids *unit, int inNumSamples)
     
     for(int count = 0; count < inNumSamples; count += size) {
         // render
-        osc->Render(sync_buffer, buffer, BLOCK_SIZE);
+        {
+            MI_PROFILE_SCOPE(gProfiler, osc->shape(), BLOCK_SIZE);
+            osc->Render(sync_buffer, buffer, BLOCK_SIZE);
+        }
         
         for (int i = 0; i < size; ++i) {
             
@@ -460,31 +673,38 @@ void MiBraids_next_reduc( MiBraids *unit, int inNumSamples)
 
 #pragma mark ---------- callback function -----------
 
-static long
-src_input_callback(void *cb_data, float **audio)
+static void
+MiBraids_RenderBlock(PROCESS_CB_DATA *data, float *out)
 {
-    PROCESS_CB_DATA *data = (PROCESS_CB_DATA *) cb_data;
-    const int input_frames = BLOCK_SIZE;
-    
     int16_t     *buffer = data->buffer;
     uint8_t     *sync_buffer = data->sync_buffer;
-    float       *samps = data->samps;
 
-    data->osc->Render(sync_buffer, buffer, input_frames);
+    {
+        MI_PROFILE_SCOPE(gProfiler, data->osc->shape(), BLOCK_SIZE);
+        data->osc->Render(sync_buffer, buffer, BLOCK_SIZE);
+    }
     
-    for (size_t i = 0; i < input_frames; ++i) {
-        samps[i] = (buffer[i] * SAMP_SCALE);
+    for (size_t i = 0; i < BLOCK_SIZE; ++i) {
+        out[i] = (buffer[i] * SAMP_SCALE);
     }
+}
+
+static long
+src_input_callback(void *cb_data, float **audio)
+{
+    PROCESS_CB_DATA *data = (PROCESS_CB_DATA *) cb_data;
     
-    *audio = &(samps [0]);
+    MiBraids_RenderBlock(data, data->samps);
+    *audio = &(data->samps [0]);
     
-    return input_frames;
+    return BLOCK_SIZE;
 }
 
 
 PluginLoad(MiBraids) {
     ft = inTable;
     DefineDtorUnit(MiBraids);
+    MI_PROFILE_COMMAND("miBraidsProfile");
 }
 
 
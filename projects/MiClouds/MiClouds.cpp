@@ -35,13 +35,42 @@
 #include "clouds/resources.h"
 #include "clouds/dsp/audio_buffer.h"
 #include "clouds/dsp/mu_law.h"
-#include "clouds/dsp/sample_rate_converter.h"
+#include "stmlib/utils/random.h"
+
+#include <atomic>
+#include <new>
+#include <thread>
+
+#if defined(__APPLE__)
+#include <dispatch/dispatch.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#else
+#include <semaphore.h>
+#endif
+
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#endif
 
 static InterfaceTable *ft;
 
+#include "MiProfile.h"     // needs ft
+
+MI_PROFILER(gProfiler, "MiClouds", "mode", 4);
+
 
 const uint16 kAudioBlockSize = 32;        // sig vs can't be smaller than this!
-const uint16 kNumArgs = 14;
+const uint16 kNumArgs = 17;
+const uint16 kMaxLatency = 8;             // in server blocks
+const uint16 kMaxPipelines = 1024;        // max. number of threaded instances
+const uint16 kMaxThreads = 4;
+
+// default memory, as on the module. The part of the large buffer exceeding the
+// small one is the FX workspace, the rest is split between the two channels.
+const int kLargeBufferSize = 118784;
+const int kSmallBufferSize = 65536-128;
+const int kWorkspaceSize = kLargeBufferSize - kSmallBufferSize;
 
 
 enum ModParams {
@@ -56,13 +85,224 @@ enum ModParams {
 
 
 
+#pragma mark ----- worker thread -----
+
+// In threaded mode, both Process() and Prepare() of the GranularProcessor run
+// on a worker thread. The audio thread only hands over input blocks with the
+// parameters they must be rendered with, and picks up the output rendered a
+// fixed number of server blocks earlier.
+
+// One block of audio and the settings it has to be processed with.
+struct BlockSlot {
+    clouds::FloatFrame      input[kAudioBlockSize];
+    clouds::FloatFrame      output[kAudioBlockSize];
+    clouds::Parameters      parameters;
+    clouds::PlaybackMode    playback_mode;
+    bool                    low_fidelity;
+    uint32                  clock;          // block count of the audio thread
+};
+
+// Single producer (audio thread), single consumer (worker) ring of blocks.
+struct Pipeline {
+    clouds::GranularProcessor   *processor;
+    BlockSlot                   *slots;
+    uint32                      num_slots;
+    uint32                      latency;        // in blocks of kAudioBlockSize
+    int                         entry;          // in the worker's table
+    
+    // memory of the freed unit, released once no worker renders it anymore
+    uint8_t                     *large_buffer;
+    uint8_t                     *small_buffer;
+    
+    std::atomic<uint32>         written;        // blocks handed to the worker
+    std::atomic<uint32>         processed;      // blocks rendered by the worker
+    
+    // audio thread only
+    uint32                      clock;          // blocks since the Ctor
+    uint32                      read;           // next block to output
+    uint32                      underruns;      // rendered too late
+    uint32                      overruns;       // dropped, the ring was full
+    uint32_t                    rng_state;      // worker only
+    
+    void Render() {
+        stmlib::ScopedRandomState rng(&rng_state);
+        uint32 block = processed.load(std::memory_order_relaxed);
+        BlockSlot *slot = &slots[block % num_slots];
+        processor->set_playback_mode(slot->playback_mode);
+        processor->set_low_fidelity(slot->low_fidelity);
+        *processor->mutable_parameters() = slot->parameters;
+        MI_PROFILE_SCOPE(gProfiler, slot->playback_mode, kAudioBlockSize);
+        processor->Process(slot->input, slot->output, kAudioBlockSize);
+        processor->Prepare();
+        processed.store(block + 1, std::memory_order_release);
+    }
+};
+
+
+// Counting semaphore. Posting doesn't take a lock, so the audio thread can
+// wake up the workers.
+class Semaphore {
+public:
+#if defined(__APPLE__)
+    Semaphore() { sem_ = dispatch_semaphore_create(0); }
+    void Post() { dispatch_semaphore_signal(sem_); }
+    void Wait() { dispatch_semaphore_wait(sem_, DISPATCH_TIME_FOREVER); }
+private:
+    dispatch_semaphore_t    sem_;
+#elif defined(_WIN32)
+    Semaphore() { sem_ = CreateSemaphore(NULL, 0, LONG_MAX, NULL); }
+    void Post() { ReleaseSemaphore(sem_, 1, NULL); }
+    void Wait() { WaitForSingleObject(sem_, INFINITE); }
+private:
+    HANDLE                  sem_;
+#else
+    Semaphore() { sem_init(&sem_, 0, 0); }
+    void Post() { sem_post(&sem_); }
+    void Wait() { while(sem_wait(&sem_) != 0) { } }     // EINTR
+private:
+    sem_t                   sem_;
+#endif
+};
+
+
+class Worker {
+public:
+    Worker() : started_(false), quit_(false), pending_(false),
+               num_entries_(0), num_threads_(0) {
+        for(int i=0; i<kMaxPipelines; ++i) {
+            entries_[i].pipeline.store(NULL);
+            entries_[i].busy.store(false);
+        }
+    }
+    
+    // Lock-free, called from Ctor. Returns false if all entries are taken.
+    // The first registration starts the threads, on the NRT thread.
+    bool Register(World *world, Pipeline *pipeline) {
+        for(int i=0; i<kMaxPipelines; ++i) {
+            Pipeline *expected = NULL;
+            if(entries_[i].pipeline.compare_exchange_strong(expected, pipeline)) {
+                int n = num_entries_.load();
+                while(n < i + 1 && !num_entries_.compare_exchange_weak(n, i + 1)) { }
+                pipeline->entry = i;
+                if(!started_.exchange(true))
+                    DoAsynchronousCommand(world, 0, 0, this,
+                                          Worker::Start, 0, 0, 0, 0, 0);
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    // Lock-free, called from Dtor. A worker may still be rendering the last
+    // block of the pipeline, see Busy().
+    void Unregister(Pipeline *pipeline) {
+        entries_[pipeline->entry].pipeline.store(NULL);
+    }
+    
+    // No worker touches the pipeline anymore once this is false after
+    // Unregister(), which takes at most the rendering of one block.
+    bool Busy(Pipeline *pipeline) {
+        return entries_[pipeline->entry].busy.load();
+    }
+    
+    // Wakes up the workers, without a lock. Only posts if the last wake-up
+    // was already picked up.
+    void Signal() {
+        if(!pending_.exchange(true))
+            semaphore_.Post();
+    }
+    
+    // Ends and joins the threads, on plugin unload.
+    void Stop() {
+        quit_.store(true);
+        for(int i=0; i<num_threads_; ++i)
+            semaphore_.Post();
+        for(int i=0; i<num_threads_; ++i)
+            threads_[i].join();
+        num_threads_ = 0;
+    }
+    
+private:
+    struct Entry {
+        std::atomic<Pipeline*>  pipeline;
+        std::atomic<bool>       busy;
+    };
+    
+    static bool Start(World *world, void *data) {      // NRT
+        Worker *worker = (Worker*)data;
+        int num_threads = std::thread::hardware_concurrency() / 2;
+        CONSTRAIN(num_threads, 1, kMaxThreads);
+        for(int i=0; i<num_threads; ++i)
+            worker->threads_[i] = std::thread(&Worker::Run, worker);
+        worker->num_threads_ = num_threads;
+        return false;
+    }
+    
+    void Run() {
+#if defined(__SSE__) || defined(_M_X64)
+        // flush denormals to zero, as scsynth does on the audio thread
+        _mm_setcsr(_mm_getcsr() | 0x8040);
+#endif
+        for(;;) {
+            semaphore_.Wait();
+            if(quit_.load())
+                return;
+            pending_.exchange(false);
+            bool work_done;
+            do {
+                work_done = false;
+                for(int i=0; i<num_entries_.load(); ++i)
+                    work_done |= Service(&entries_[i]);
+            } while(work_done);
+        }
+    }
+    
+    bool Service(Entry *entry) {
+        Pipeline *pipeline = entry->pipeline.load();
+        if(pipeline == NULL || entry->busy.exchange(true))
+            return false;
+        
+        bool work_done = false;
+        // re-check the pipeline before each block, it might have been freed.
+        while(entry->pipeline.load() == pipeline &&
+              pipeline->processed.load(std::memory_order_relaxed) !=
+              pipeline->written.load(std::memory_order_acquire)) {
+            pipeline->Render();
+            work_done = true;
+        }
+        entry->busy.store(false);
+        return work_done;
+    }
+    
+    Entry                   entries_[kMaxPipelines];
+    Semaphore               semaphore_;
+    std::atomic<bool>       started_;
+    std::atomic<bool>       quit_;
+    std::atomic<bool>       pending_;       // posted, not picked up yet
+    std::atomic<int>        num_entries_;
+    std::thread             threads_[kMaxThreads];
+    int                     num_threads_;
+};
+
+// created on plugin load and destroyed on unload. The threads are only started
+// with the first threaded instance.
+static Worker *gWorker = NULL;
+
+
+
 struct MiClouds : public Unit {
     
     clouds::GranularProcessor   *processor;
+    Pipeline                    *pipeline;      // NULL if not threaded
+    
+    // parameters handed to the worker thread
+    clouds::Parameters          parameters;
     
     // buffers
     uint8_t     *large_buffer;
     uint8_t     *small_buffer;
+    SndBuf      *buf;           // if running on the memory of a SC Buffer
+    float       *buf_data;
     
     // parameters
     float       in_gain;
@@ -83,10 +323,7 @@ struct MiClouds : public Unit {
     bool        gate_connected;
     bool        trig_connected;
     uint32      pcount;
-    
-    
-    clouds::SampleRateConverter<-clouds::kDownsamplingFactor, 45, clouds::src_filter_1x_2_45> src_down_;
-    clouds::SampleRateConverter<+clouds::kDownsamplingFactor, 45, clouds::src_filter_1x_2_45> src_up_;
+    uint32_t    rng_state;
     
 };
 
@@ -97,34 +334,151 @@ static void MiClouds_Dtor(MiClouds *unit);
 static void MiClouds_next(MiClouds *unit, int inNumSamples);
 
 
+static void MiClouds_InitPipeline(MiClouds *unit, uint32 latency) {
+    
+    Pipeline *pipeline = (Pipeline*)RTAlloc(unit->mWorld, sizeof(Pipeline));
+    if(pipeline == NULL) {
+        Print("MiClouds: mem alloc failed, running unthreaded!\n");
+        return;
+    }
+    new(pipeline) Pipeline;
+    
+    // the worker may lag 'latency' blocks behind, plus one server block
+    pipeline->num_slots = latency + 2 * (BUFLENGTH / kAudioBlockSize);
+    pipeline->slots = (BlockSlot*)RTAlloc(unit->mWorld,
+                                          pipeline->num_slots * sizeof(BlockSlot));
+    if(pipeline->slots == NULL) {
+        Print("MiClouds: mem alloc failed, running unthreaded!\n");
+        pipeline->~Pipeline();
+        RTFree(unit->mWorld, pipeline);
+        return;
+    }
+    memset(pipeline->slots, 0, pipeline->num_slots * sizeof(BlockSlot));
+    
+    pipeline->processor = unit->processor;
+    pipeline->latency = latency;
+    pipeline->large_buffer = NULL;
+    pipeline->small_buffer = NULL;
+    pipeline->written.store(0);
+    pipeline->processed.store(0);
+    pipeline->clock = 0;
+    pipeline->read = 0;
+    pipeline->underruns = 0;
+    pipeline->overruns = 0;
+    pipeline->rng_state = stmlib::Random::state();  // bound by the Ctor
+    
+    // from now on, only the worker touches the processor
+    unit->parameters = unit->processor->parameters();
+    if(!gWorker->Register(unit->mWorld, pipeline)) {
+        Print("MiClouds: too many threaded instances, running unthreaded!\n");
+        RTFree(unit->mWorld, pipeline->slots);
+        pipeline->~Pipeline();
+        RTFree(unit->mWorld, pipeline);
+        return;
+    }
+    unit->pipeline = pipeline;
+}
+
+
+// Looks up the Buffer given as record memory. Returns false (and the Ctor falls
+// back to the default memory) if there is none, or if it is too small.
+static bool MiClouds_GetBuffer(MiClouds *unit, float fbufnum) {
+    
+    if(fbufnum < 0.f)
+        return false;
+    
+    uint32 bufnum = (uint32)fbufnum;
+    World *world = unit->mWorld;
+    if(bufnum >= world->mNumSndBufs) {
+        Print("MiClouds: invalid buffer number %d, using the internal memory\n", bufnum);
+        return false;
+    }
+    
+    SndBuf *buf = world->mSndBufs + bufnum;
+    size_t min_samples = (kLargeBufferSize + kSmallBufferSize) / sizeof(float);
+    if(buf->data == NULL || buf->samples < (int)min_samples) {
+        Print("MiClouds: buffer %d needs at least %d samples, using the internal memory\n",
+              bufnum, (int)min_samples);
+        return false;
+    }
+    
+    unit->buf = buf;
+    unit->buf_data = buf->data;
+    return true;
+}
+
+
 static void MiClouds_Ctor(MiClouds *unit) {
     
+    unit->pipeline = NULL;
+    unit->processor = NULL;
+    unit->large_buffer = unit->small_buffer = NULL;
+    unit->buf = NULL;
+    unit->buf_data = NULL;
+    
     if(BUFLENGTH < kAudioBlockSize) {
         Print("MiClouds ERROR: Block Size can't be smaller than %d samples\n", kAudioBlockSize);
-        unit = NULL;
+        SETCALC(ClearUnitOutputs);
+        ClearUnitOutputs(unit, 1);
         return;
     }
     
-    int largeBufSize = 118784;
-    int smallBufSize = 65536-128;
+    uint32_t seed = static_cast<int32_t>(IN0(15));
+    unit->rng_state = seed ? seed : unit->mParent->mRGen->trand();
+    stmlib::ScopedRandomState rng(&unit->rng_state);
     
-    // alloc mem
-    unit->large_buffer = (uint8_t*)RTAlloc(unit->mWorld, largeBufSize * sizeof(uint8_t));
-    unit->small_buffer = (uint8_t*)RTAlloc(unit->mWorld, smallBufSize * sizeof(uint8_t));
-
+    // optional threaded mode, with a fixed latency of 'latency' server blocks
+    int latency = IN0(14);
+    CONSTRAIN(latency, 0, kMaxLatency);
     
-    if(unit->large_buffer == NULL || unit->small_buffer == NULL) {
-        Print( "mem alloc failed!" );
-        unit = NULL;
-        return;
+    int largeBufSize = kLargeBufferSize;
+    int smallBufSize = kSmallBufferSize;
+    uint8_t *large_buffer, *small_buffer;
+    
+    // a worker could still be rendering into a Buffer that is freed in between
+    // two blocks, so threaded units keep to their own memory
+    float bufnum = IN0(16);
+    if(latency > 0 && bufnum >= 0.f) {
+        Print("MiClouds: no buffer in threaded mode, using the internal memory\n");
+        bufnum = -1.f;
+    }
+    
+    if(MiClouds_GetBuffer(unit, bufnum)) {
+        // use the Buffer's memory in place: large buffer first, small one at the end
+        size_t bytes = unit->buf->samples * sizeof(float);
+        smallBufSize = ((bytes - kWorkspaceSize) / 2) & ~15;
+        largeBufSize = smallBufSize + kWorkspaceSize;
+        large_buffer = reinterpret_cast<uint8_t*>(unit->buf_data);
+        small_buffer = large_buffer + largeBufSize;
+    }
+    else {
+        // alloc mem
+        unit->large_buffer = (uint8_t*)RTAlloc(unit->mWorld, largeBufSize * sizeof(uint8_t));
+        unit->small_buffer = (uint8_t*)RTAlloc(unit->mWorld, smallBufSize * sizeof(uint8_t));
+        
+        if(unit->large_buffer == NULL || unit->small_buffer == NULL) {
+            Print( "mem alloc failed!" );
+            SETCALC(ClearUnitOutputs);
+            ClearUnitOutputs(unit, 1);
+            return;
+        }
+        large_buffer = unit->large_buffer;
+        small_buffer = unit->small_buffer;
     }
     
     unit->sr = SAMPLERATE;
     
-    unit->processor = new clouds::GranularProcessor;
+    unit->processor = (clouds::GranularProcessor*)RTAlloc(unit->mWorld, sizeof(clouds::GranularProcessor));
+    if(unit->processor == NULL) {
+        Print( "mem alloc failed!" );
+        SETCALC(ClearUnitOutputs);
+        ClearUnitOutputs(unit, 1);
+        return;
+    }
     memset(unit->processor, 0, sizeof(*unit->processor));
+    new(unit->processor) clouds::GranularProcessor;
     //Print("sizeof processor: %d\n", sizeof(*unit->processor));
-    unit->processor->Init(unit->large_buffer, largeBufSize, unit->small_buffer, smallBufSize);
+    unit->processor->Init(large_buffer, largeBufSize, small_buffer, smallBufSize);
     unit->processor->set_sample_rate(unit->sr);
     unit->processor->set_num_channels(2);       // always use stereo setup
     unit->processor->set_low_fidelity(false);
@@ -147,11 +501,11 @@ static void MiClouds_Ctor(MiClouds *unit) {
     unit->coef = 0.1f;
     unit->previous_trig = false;
     
-    unit->src_down_.Init();
-    unit->src_up_.Init();
-    
     unit->pcount = 0;
     
+    if(latency > 0)
+        MiClouds_InitPipeline(unit, latency * (BUFLENGTH / kAudioBlockSize));
+    
     uint16 numAudioInputs = unit->mNumInputs - kNumArgs;
 //    Print("MiClouds > numAudioIns: %d\n", numAudioInputs);
     
@@ -162,15 +516,61 @@ static void MiClouds_Ctor(MiClouds *unit) {
 }
 
 
+// A worker may still be rendering the last block of a freed unit: its memory
+// is only released once the worker is done, which is waited for on the NRT
+// thread.
+static bool MiClouds_WaitForWorker(World *world, void *data) {     // NRT
+    Pipeline *pipeline = (Pipeline*)data;
+    while(gWorker->Busy(pipeline))
+        std::this_thread::yield();
+    return true;
+}
+
+static bool MiClouds_FreePipeline(World *world, void *data) {      // RT
+    Pipeline *pipeline = (Pipeline*)data;
+    if(pipeline->large_buffer)
+        RTFree(world, pipeline->large_buffer);
+    if(pipeline->small_buffer)
+        RTFree(world, pipeline->small_buffer);
+    pipeline->processor->~GranularProcessor();
+    RTFree(world, pipeline->processor);
+    RTFree(world, pipeline->slots);
+    pipeline->~Pipeline();
+    RTFree(world, pipeline);
+    return false;
+}
+
+
 static void MiClouds_Dtor(MiClouds *unit) {
     
+    if(unit->pipeline) {
+        Pipeline *pipeline = unit->pipeline;
+        gWorker->Unregister(pipeline);
+        if(pipeline->underruns)
+            Print("MiClouds: %d blocks were late, try a larger latency\n",
+                  pipeline->underruns);
+        if(pipeline->overruns)
+            Print("MiClouds: %d blocks were dropped, the worker threads can't keep up\n",
+                  pipeline->overruns);
+        // the pipeline takes the memory the worker renders with along
+        pipeline->large_buffer = unit->large_buffer;
+        pipeline->small_buffer = unit->small_buffer;
+        unit->large_buffer = unit->small_buffer = NULL;
+        unit->processor = NULL;
+        DoAsynchronousCommand(unit->mWorld, 0, 0, pipeline,
+                              MiClouds_WaitForWorker, MiClouds_FreePipeline, 0,
+                              0, 0, 0);
+    }
     if(unit->large_buffer) {
         RTFree(unit->mWorld, unit->large_buffer);
     }
     if(unit->small_buffer) {
         RTFree(unit->mWorld, unit->small_buffer);
     }
-    if(unit->processor) delete unit->processor;
+    if(unit->processor) {
+        unit->processor->~GranularProcessor();
+        RTFree(unit->mWorld, unit->processor);
+    }
 }
 
 
@@ -179,6 +579,8 @@ static void MiClouds_Dtor(MiClouds *unit) {
 
 void MiClouds_next( MiClouds *unit, int inNumSamples )
 {
+    stmlib::ScopedRandomState rng(&unit->rng_state);
+    
     float   pitch = IN0(0);
 
     float   in_gain = IN0(6);
@@ -195,6 +597,16 @@ void MiClouds_next( MiClouds *unit, int inNumSamples )
     float   *outR = OUT(1);
     
     int vs = inNumSamples;
+    
+    // the Buffer was freed or reallocated under our feet
+    if(unit->buf && unit->buf->data != unit->buf_data) {
+        if(unit->buf_data) {
+            Print("MiClouds: buffer changed, the unit is silent from now on\n");
+            unit->buf_data = NULL;
+        }
+        ClearUnitOutputs(unit, inNumSamples);
+        return;
+    }
 
     // find out number of audio inputs
     uint16 numAudioInputs = unit->mNumInputs - kNumArgs;
@@ -211,7 +623,8 @@ void MiClouds_next( MiClouds *unit, int inNumSamples )
     
     
     clouds::GranularProcessor   *gp = unit->processor;
-    clouds::Parameters   *p = gp->mutable_parameters();
+    Pipeline                    *pipeline = unit->pipeline;
+    clouds::Parameters   *p = pipeline ? &unit->parameters : gp->mutable_parameters();
 
     
     
@@ -243,9 +656,11 @@ void MiClouds_next( MiClouds *unit, int inNumSamples )
     p->stereo_spread = spread;
     p->reverb = reverb;
     p->feedback = fb;
-    gp->set_low_fidelity(lofi);
-    gp->set_freeze(freeze);
-    gp->set_playback_mode(static_cast<clouds::PlaybackMode>(mode));
+    p->freeze = freeze;
+    if(!pipeline) {
+        gp->set_low_fidelity(lofi);
+        gp->set_playback_mode(static_cast<clouds::PlaybackMode>(mode));
+    }
     
     
     
@@ -253,6 +668,19 @@ void MiClouds_next( MiClouds *unit, int inNumSamples )
     
     for(int count = 0; count < vs; count += kAudioBlockSize) {
         
+        BlockSlot *slot = NULL;
+        uint32 block = 0;
+        if(pipeline) {
+            block = pipeline->written.load(std::memory_order_relaxed);
+            // if the worker is too far behind, the block is dropped.
+            if(block - pipeline->processed.load(std::memory_order_acquire)
+               < pipeline->num_slots)
+                slot = &pipeline->slots[block % pipeline->num_slots];
+            else
+                ++pipeline->overruns;
+            input = slot ? slot->input : unit->input;
+        }
+        
         for(int i=0; i<kAudioBlockSize; ++i) {
             input[i].l = IN(kNumArgs)[i + count] * in_gain;
             input[i].r = IN(kNumArgs+1)[i + count] * in_gain;
@@ -276,8 +704,38 @@ void MiClouds_next( MiClouds *unit, int inNumSamples )
         unit->previous_trig = trigger;
         
         
-        gp->Process(input, output, kAudioBlockSize);
-        gp->Prepare();      // muss immer hier sein?
+        if(pipeline) {
+            if(slot) {
+                slot->parameters = *p;
+                slot->playback_mode = static_cast<clouds::PlaybackMode>(mode);
+                slot->low_fidelity = lofi;
+                slot->clock = pipeline->clock;
+                pipeline->written.store(++block, std::memory_order_release);
+            }
+            // pick up the block handed over 'latency' blocks ago. The blocks
+            // are matched by their clock, so a dropped block stays silent
+            // and doesn't move the latency.
+            uint32 due = pipeline->clock++ - pipeline->latency;
+            BlockSlot *pending = &pipeline->slots[pipeline->read % pipeline->num_slots];
+            output = NULL;
+            if(pipeline->read != block && pending->clock == due) {
+                uint32 ready = pipeline->processed.load(std::memory_order_acquire);
+                if((int32)(ready - pipeline->read) > 0)
+                    output = pending->output;
+                else
+                    ++pipeline->underruns;
+                ++pipeline->read;
+            }
+            if(output == NULL) {
+                output = unit->output;
+                memset(output, 0, kAudioBlockSize * sizeof(clouds::FloatFrame));
+            }
+        }
+        else {
+            MI_PROFILE_SCOPE(gProfiler, mode, kAudioBlockSize);
+            gp->Process(input, output, kAudioBlockSize);
+            gp->Prepare();      // muss immer hier sein?
+        }
         
         if(p->trigger)
             p->trigger = false;
@@ -287,6 +745,9 @@ void MiClouds_next( MiClouds *unit, int inNumSamples )
             outR[i + count] = output[i].r;
         }
     }
+    
+    if(pipeline)
+        gWorker->Signal();
 }
 
 
@@ -294,5 +755,15 @@ void MiClouds_next( MiClouds *unit, int inNumSamples )
 
 PluginLoad(MiClouds) {
     ft = inTable;
+    gWorker = new Worker;
     DefineDtorUnit(MiClouds);
+    MI_PROFILE_COMMAND("miCloudsProfile");
+}
+
+#ifdef PluginUnload
+PluginUnload(MiClouds) {
+    gWorker->Stop();
+    delete gWorker;
+    gWorker = NULL;
 }
+#endif
@@ -35,15 +35,25 @@
 
 #include "elements/dsp/dsp.h"
 #include "elements/dsp/part.h"
+#include "stmlib/dsp/silence_detector.h"
+#include "stmlib/utils/random.h"
 
+#include <new>
 
-float elements::Dsp::kSampleRate = 32000.0f; 
-float elements::Dsp::kSrFactor = 32000.0f / kSampleRate;
-float elements::Dsp::kIntervalCorrection = logf(kSrFactor)/logf(2.0f)*12.0f;
 
 
 static InterfaceTable *ft;
 
+#include "MiProfile.h"     // needs ft
+
+MI_PROFILER(gProfiler, "MiElements", "model", 3);
+
+// idle voices: with the gate off and silent inputs and outputs, the part
+// isn't processed anymore until the gate, an input or one of the parameters
+// (inputs 3 -- 20) changes
+const int   kFirstParam = 3;
+const int   kNumParams = 18;
+
 
 struct MiElements : public Unit {
     
@@ -55,12 +65,16 @@ struct MiElements : public Unit {
     float               *strike_in;
     float               *silence;
 
-    uint16_t            *reverb_buffer;
+    elements::FxBufferType *reverb_buffer;
     float               *out, *aux;     // output buffers
     double              sr;
     long                sigvs;
     
     short               blockCount;
+    uint32_t            rng_state;
+    
+    stmlib::SilenceDetector silence_detector;
+    float               sleep_params[kNumParams];  // when it fell asleep
     
 };
 
@@ -72,21 +86,28 @@ static void MiElements_next(MiElements *unit, int inNumSamples);
 
 static void MiElements_Ctor(MiElements *unit) {
     
+    unit->part = NULL;
+    unit->reverb_buffer = NULL;
+    unit->silence = unit->out = unit->aux = NULL;
+    
     if(BUFLENGTH < elements::kMaxBlockSize) {
         Print("MiElements ERROR: Block Size can't be smaller than %d samples\n", elements::kMaxBlockSize);
-        unit = NULL;
+        SETCALC(ClearUnitOutputs);
+        ClearUnitOutputs(unit, 1);
         return;
     }
     
-    elements::Dsp::setSr(SAMPLERATE);
-    
+    uint32_t seed = unit->mNumInputs > 21 ? static_cast<int32_t>(IN0(21)) : 0;
+    unit->rng_state = seed ? seed : unit->mParent->mRGen->trand();
+    stmlib::ScopedRandomState rng(&unit->rng_state);
     
     // allocate memory
-    unit->reverb_buffer = (uint16_t*)RTAlloc(unit->mWorld, 32768*sizeof(uint16_t));
+    unit->reverb_buffer = (elements::FxBufferType*)RTAlloc(unit->mWorld, 32768*sizeof(elements::FxBufferType));
     
     if(unit->reverb_buffer == NULL) {
         Print("MiElements ERROR: mem alloc failed!\n");
-        unit = NULL;
+        SETCALC(ClearUnitOutputs);
+        ClearUnitOutputs(unit, 1);
         return;
     }
     
@@ -98,17 +119,27 @@ static void MiElements_Ctor(MiElements *unit) {
 
     
     // Init and seed the random parameters and generators with the serial number.
-    unit->part = new elements::Part;
+    unit->part = (elements::Part*)RTAlloc(unit->mWorld, sizeof(elements::Part));
+    if(unit->part == NULL) {
+        Print("MiElements ERROR: mem alloc failed!\n");
+        SETCALC(ClearUnitOutputs);
+        ClearUnitOutputs(unit, 1);
+        return;
+    }
     memset(unit->part, 0, sizeof(*unit->part));
-    unit->part->Init(unit->reverb_buffer);
-    uint32_t mySeed = 0x1fff7a10;
-    unit->part->Seed(&mySeed, 3);
+    new(unit->part) elements::Part;
+    unit->part->Init(unit->reverb_buffer, SAMPLERATE);
+    // the hardware hashes the 96-bit chip serial number, so seed with 3 words
+    uint32_t mySeed[3] = { 0x1fff7a10, 0, 0 };
+    unit->part->Seed(mySeed, 3);
     
     unit->part->set_easter_egg(false);   
     unit->p = unit->part->mutable_patch();
     
     unit->blockCount = 0;
     
+    unit->silence_detector.Init(SAMPLERATE);
+    
     unit->p->exciter_envelope_shape = 0.1f;
     unit->p->exciter_bow_level = 0.f;
     unit->p->exciter_blow_level = 0.f;
@@ -140,8 +171,10 @@ static void MiElements_Dtor(MiElements *unit) {
     if(unit->reverb_buffer) {
         RTFree(unit->mWorld, unit->reverb_buffer);
     }
-    if(unit->part)
-        delete unit->part;
+    if(unit->part) {
+        unit->part->~Part();
+        RTFree(unit->mWorld, unit->part);
+    }
     if(unit->silence)
        RTFree(unit->mWorld, unit->silence);
     if(unit->out)
@@ -174,6 +207,8 @@ inline void SoftLimit_block2(MiElements *unit, float *in, float *out, size_t siz
 
 void MiElements_next( MiElements *unit, int inNumSamples)
 {
+    stmlib::ScopedRandomState rng(&unit->rng_state);
+    
     float   *in0 = IN(0);
     float   *in1 = IN(1);
     float   *gate_in = IN(2);
@@ -296,22 +331,44 @@ void MiElements_next( MiElements *unit, int inNumSamples)
         strike_in = unit->silence;
     
     
+    float params[kNumParams];
+    for(int i=0; i<kNumParams; ++i)
+        params[i] = IN0(kFirstParam + i);
+    bool idle = !ps.gate && stmlib::SilenceDetector::IsSilent(blow_in, inNumSamples) &&
+                stmlib::SilenceDetector::IsSilent(strike_in, inNumSamples);
+    
+    if(unit->silence_detector.asleep()) {
+        if(idle && !memcmp(params, unit->sleep_params, sizeof(params))) {
+            ClearUnitOutputs(unit, inNumSamples);
+            return;
+        }
+        unit->silence_detector.Wake();
+    }
+    
+    
     // input and output can't be the same arrays
     
     for(size_t count = 0; count < inNumSamples; count += size) {
         
+        MI_PROFILE_SCOPE(gProfiler, model, size);
         unit->part->Process(ps, blow_in+count, strike_in+count, out+count, aux+count, size);
     }
     
     SoftLimit_block2(unit, out, outL, inNumSamples);
     SoftLimit_block2(unit, aux, outR, inNumSamples);
     
+    bool silent = idle && stmlib::SilenceDetector::IsSilent(outL, inNumSamples) &&
+                  stmlib::SilenceDetector::IsSilent(outR, inNumSamples);
+    if(unit->silence_detector.Process(silent, inNumSamples))
+        memcpy(unit->sleep_params, params, sizeof(params));
+    
 }
 
 
 PluginLoad(MiElements) {
     ft = inTable;
     DefineDtorUnit(MiElements);
+    MI_PROFILE_COMMAND("miElementsProfile");
 }
 
 
@@ -33,12 +33,25 @@
 #include "SC_PlugIn.h"
 
 #include "omi/dsp/part.h"
+#include "stmlib/dsp/silence_detector.h"
+
+#include <new>
 
 static InterfaceTable *ft;
 
+#include "MiProfile.h"     // needs ft
+
+MI_PROFILER(gProfiler, "MiOmi", "", 1);
+
 
 const uint16 kAudioBlockSize = omi::kMaxBlockSize;   // sig vs can't be smaller than this!
 
+// with the gate off, no input and a silent output, the voice sleeps until the
+// gate, the input or one of the parameters (inputs 2 -- 19, strength alone can
+// open the vca) changes
+const int   kFirstParam = 2;
+const int   kNumParams = 18;
+
 
 
 struct MiOmi : public Unit {
@@ -47,6 +60,9 @@ struct MiOmi : public Unit {
     omi::PerformanceState ps;
     float           *silence;
     
+    stmlib::SilenceDetector silence_detector;
+    float           sleep_params[kNumParams];
+    
 };
 
 
@@ -58,9 +74,13 @@ static void MiOmi_next(MiOmi *unit, int inNumSamples);
 
 static void MiOmi_Ctor(MiOmi *unit) {
     
+    unit->part = NULL;
+    unit->silence = NULL;
+    
     if(BUFLENGTH < kAudioBlockSize) {
         Print("MiOmi ERROR: Block Size can't be smaller than %d samples\n", kAudioBlockSize);
-        unit = NULL;
+        SETCALC(ClearUnitOutputs);
+        ClearUnitOutputs(unit, 1);
         return;
     }
     
@@ -69,11 +89,20 @@ static void MiOmi_Ctor(MiOmi *unit) {
     unit->ps.modulation = 0.0;
     unit->ps.gate = 0;
     
+    unit->silence_detector.Init(SAMPLERATE);
+    
     unit->silence = (float*)RTAlloc(unit->mWorld, kAudioBlockSize*sizeof(float));
+    unit->part = (omi::Part*)RTAlloc(unit->mWorld, sizeof(omi::Part));
+    if(unit->silence == NULL || unit->part == NULL) {
+        Print("MiOmi ERROR: mem alloc failed!\n");
+        SETCALC(ClearUnitOutputs);
+        ClearUnitOutputs(unit, 1);
+        return;
+    }
     memset(unit->silence, 0, kAudioBlockSize*sizeof(float));
     
     // Init and seed the random parameters and generators with the serial number.
-    unit->part = new omi::Part;
+    new(unit->part) omi::Part;
     unit->part->Init(SAMPLERATE);
     
     uint32_t mySeed = 0x1fff7a10;
@@ -88,8 +117,12 @@ static void MiOmi_Ctor(MiOmi *unit) {
 
 static void MiOmi_Dtor(MiOmi *unit) {
     
-    delete unit->part;
-    RTFree(unit->mWorld, unit->silence);
+    if(unit->part) {
+        unit->part->~Part();
+        RTFree(unit->mWorld, unit->part);
+    }
+    if(unit->silence)
+        RTFree(unit->mWorld, unit->silence);
 }
 
 
@@ -209,13 +242,31 @@ void MiOmi_next( MiOmi *unit, int inNumSamples )
     
     ps->gate = ( sum > 0.f );
     
+    
+    float params[kNumParams];
+    for(int i=0; i<kNumParams; ++i)
+        params[i] = IN0(kFirstParam + i);
+    bool idle = !ps->gate &&
+                (INRATE(0) != calc_FullRate || stmlib::SilenceDetector::IsSilent(audio_in, vs));
+    
+    if(unit->silence_detector.asleep()) {
+        if(idle && !memcmp(params, unit->sleep_params, sizeof(params))) {
+            ClearUnitOutputs(unit, vs);
+            return;
+        }
+        unit->silence_detector.Wake();
+    }
+    
+    
     if(INRATE(0) == calc_FullRate) {
         for(int count = 0; count < vs; count += size) {
+            MI_PROFILE_SCOPE(gProfiler, 0, size);
             unit->part->Process(*ps, audio_in+count, outL+count, outR+count, size);
         }
     }
     else {
         for(int count = 0; count < vs; count += size) {
+            MI_PROFILE_SCOPE(gProfiler, 0, size);
             unit->part->Process(*ps, unit->silence, outL+count, outR+count, size);
         }
     }
@@ -223,6 +274,11 @@ void MiOmi_next( MiOmi *unit, int inNumSamples )
 
     SoftLimit_block(unit, outL, vs);
     SoftLimit_block(unit, outR, vs);
+    
+    bool silent = idle && stmlib::SilenceDetector::IsSilent(outL, vs) &&
+                  stmlib::SilenceDetector::IsSilent(outR, vs);
+    if(unit->silence_detector.Process(silent, vs))
+        memcpy(unit->sleep_params, params, sizeof(params));
 }
 
 
@@ -231,4 +287,5 @@ void MiOmi_next( MiOmi *unit, int inNumSamples )
 PluginLoad(MiOmi) {
     ft = inTable;
     DefineDtorUnit(MiOmi);
+    MI_PROFILE_COMMAND("miOmiProfile");
 }
@@ -91,6 +91,8 @@ class FmOscillator {
       intervalCorrection_ = logf(srFactor)/logf(2.0f)*12.0f;        // vb
     fm_amount_ = 0.0f;
     previous_sample_ = 0.0f;
+    phase_carrier_ = 0;
+    phase_mod_ = 0;
       lp_filter[0].Init();
       lp_filter[1].Init();
       // vb: use two onepole filters in the feedback path to avoid aliasing and ringing
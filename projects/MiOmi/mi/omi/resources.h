@@ -35,6 +35,7 @@
 
 
 #include "stmlib/stmlib.h"
+#include "stmlib/resources.h"
 
 
 
@@ -58,20 +59,20 @@ extern const float lut_approx_svf_gain[];
 extern const float lut_approx_svf_g[];
 extern const float lut_approx_svf_r[];
 extern const float lut_approx_svf_h[];
-extern const float lut_4_decades[];
+using stmlib::lut_4_decades;
 extern const float lut_accent_gain_coarse[];
 extern const float lut_accent_gain_fine[];
-extern const float lut_stiffness[];
+using stmlib::lut_stiffness;
 extern const float lut_env_increments[];
 extern const float lut_env_linear[];
 extern const float lut_env_expo[];
 extern const float lut_env_quartic[];
 extern const float lut_midi_to_f_high[];
 extern const float lut_midi_to_increment_high[];
-extern const float lut_midi_to_f_low[];
-extern const float lut_fm_frequency_quantizer[];
+using stmlib::lut_midi_to_f_low;
+using stmlib::lut_fm_frequency_quantizer;
 extern const float lut_detune_quantizer[];
-extern const float lut_svf_shift[];
+using stmlib::lut_svf_shift;
 extern const int16_t smp_sample_data[];
 extern const int16_t smp_noise_sample[];
 extern const size_t smp_boundaries[];
@@ -31,18 +31,39 @@
 
 #include "plaits/dsp/dsp.h"
 #include "plaits/dsp/voice.h"
+#include "stmlib/utils/random.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
 
 
-float kSampleRate = 48000.0f;
-float a0 = (440.0f / 8.0f) / kSampleRate;
 const size_t   kBlockSize = plaits::kBlockSize;
+const size_t   kSharedBufferSize = 32768;
+const int      kMaxPoolSize = 1024;
 
 static InterfaceTable *ft;
 
+#include "MiProfile.h"     // needs ft
+
+MI_PROFILER(gProfiler, "MiPlaits", "engine", plaits::kMaxEngines);
+MI_PROFILER(gPolyProfiler, "MiPlaitsPoly", "engine", plaits::kMaxEngines);
+
+struct VoicePool;
+struct PatchBank;
+
+// A voice and its memory, either checked out of the pool or owned.
+struct VoiceSlot {
+    plaits::Voice           *voice;
+    char                    *shared_buffer;
+    stmlib::BufferAllocator allocator;
+    VoicePool               *pool;      // set if voice is checked out of it
+};
+
 
 struct MiPlaits : public Unit {
     
-    plaits::Voice       *voice_;
+    VoiceSlot           slot;
     plaits::Modulations modulations;
     plaits::Patch       patch;
     float               transposition_;
@@ -50,31 +71,506 @@ struct MiPlaits : public Unit {
     short               trigger_connected;
     short               trigger_toggle;
     
-    char                *shared_buffer;
     void                *info_out;
     bool                prev_trig;
     float               sr;
     int                 sigvs;
+    uint32_t            rng_state;
+    PatchBank           *bank;
 };
 
 
+static plaits::Voice* VoicePool_CheckOut(VoicePool *pool, float sr);
+static void VoicePool_Return(World *world, VoicePool *pool, plaits::Voice *voice);
+
+static bool PatchBank_Update(PatchBank **bank, PatchBank **previous, int bufnum);
+static const plaits::fm::Patch* PatchBank_Patches(PatchBank *bank);
+static void PatchBank_Release(World *world, PatchBank *bank);
+
 static void MiPlaits_Ctor(MiPlaits *unit);
 static void MiPlaits_Dtor(MiPlaits *unit);
 static void MiPlaits_next(MiPlaits *unit, int inNumSamples);
 
 
+// MiPlaitsPoly: voices sharing one patch, each with its own pitch, trigger
+// and level, rendered and mixed by a single unit.
+// inputs: num_voices, engine, harm, timbre, morph, fm_mod, timb_mod,
+// morph_mod, decay, lpg_colour, seed, bank, then num_voices pitches, triggers
+// and levels.
+
+const int kMaxPolyVoices = 32;
+const int kPolyVoiceInputs = 12;
+
+struct PolyVoice {
+    VoiceSlot           slot;
+    plaits::Modulations modulations;
+    float               note;
+};
+
+struct MiPlaitsPoly : public Unit {
+    
+    PolyVoice           *voices;
+    int                 num_voices;     // rendered
+    int                 num_inputs;     // per-voice input sets
+    plaits::Patch       patch;
+    uint32_t            rng_state;
+    PatchBank           *bank;
+};
+
+
+static void MiPlaitsPoly_Ctor(MiPlaitsPoly *unit);
+static void MiPlaitsPoly_Dtor(MiPlaitsPoly *unit);
+static void MiPlaitsPoly_next(MiPlaitsPoly *unit, int inNumSamples);
+
+
+
+#pragma mark ----- voice pool -----
+
+// Voices built and initialized ahead of time on the NRT thread, see the
+// 'miPlaitsPool' plugin command. A new synth checks one out instead of
+// allocating its memory on the RT thread, a freed synth hands it back. The
+// free list is only touched on the RT thread.
+
+struct PooledVoice {
+    plaits::Voice   voice;      // first member, so a Voice* is a PooledVoice*
+    stmlib::BufferAllocator allocator;
+    char            shared_buffer[kSharedBufferSize];
+};
+
+struct VoicePool {
+    PooledVoice     *voices;
+    PooledVoice     **free_voices;
+    int             size;
+    int             num_free;
+    float           sr;
+    bool            retired;    // replaced, delete when all voices are back
+};
+
+struct PoolCommand {
+    int             size;
+    float           sr;
+    VoicePool       *pool;
+};
+
+static VoicePool *gVoicePool = NULL;
+
+
+static void VoicePool_Delete(VoicePool *pool) {
+    for(int i=0; i<pool->size; ++i)
+        pool->voices[i].~PooledVoice();
+    free(pool->voices);
+    free(pool->free_voices);
+    free(pool);
+}
+
+static bool VoicePool_Create(World *world, void *data) {       // NRT
+    PoolCommand *cmd = (PoolCommand*)data;
+    if(cmd->size == 0)
+        return true;
+    
+    VoicePool *pool = (VoicePool*)malloc(sizeof(VoicePool));
+    PooledVoice *voices = (PooledVoice*)malloc(cmd->size * sizeof(PooledVoice));
+    PooledVoice **free_voices = (PooledVoice**)malloc(cmd->size * sizeof(PooledVoice*));
+    if(pool == NULL || voices == NULL || free_voices == NULL) {
+        Print("MiPlaits ERROR: mem alloc failed, pool of %d voices not built!\n", cmd->size);
+        free(pool);
+        free(voices);
+        free(free_voices);
+        return false;
+    }
+    memset(voices, 0, cmd->size * sizeof(PooledVoice));
+    
+    for(int i=0; i<cmd->size; ++i) {
+        PooledVoice *v = new(&voices[i]) PooledVoice;
+        v->allocator.Init(v->shared_buffer, kSharedBufferSize);
+        v->voice.Init(&v->allocator, cmd->sr);
+        free_voices[i] = v;
+    }
+    pool->voices = voices;
+    pool->free_voices = free_voices;
+    pool->size = pool->num_free = cmd->size;
+    pool->sr = cmd->sr;
+    pool->retired = false;
+    cmd->pool = pool;
+    return true;
+}
+
+static bool VoicePool_Install(World *world, void *data) {      // RT
+    PoolCommand *cmd = (PoolCommand*)data;
+    VoicePool *old = gVoicePool;
+    gVoicePool = cmd->pool;
+    cmd->pool = NULL;
+    if(old) {
+        if(old->num_free == old->size)
+            cmd->pool = old;        // delete it right away
+        else
+            old->retired = true;    // synths are still using it
+    }
+    return true;
+}
+
+static bool VoicePool_Dispose(World *world, void *data) {      // NRT
+    PoolCommand *cmd = (PoolCommand*)data;
+    if(cmd->pool)
+        VoicePool_Delete(cmd->pool);
+    return true;
+}
+
+static void VoicePool_FreeCommand(World *world, void *data) {  // RT
+    RTFree(world, data);
+}
+
+
+// /cmd miPlaitsPool <size>
+// Replaces the voice pool with one of <size> voices (0 removes it) at the
+// server's sample rate. Replies /done miPlaitsPool once the new pool is in use.
+static void VoicePool_Cmd(World *world, void *inUserData, struct sc_msg_iter *args, void *replyAddr) {
+    
+    int size = args->geti(0);
+    CONSTRAIN(size, 0, kMaxPoolSize);
+    
+    PoolCommand *cmd = (PoolCommand*)RTAlloc(world, sizeof(PoolCommand));
+    if(cmd == NULL) {
+        Print("MiPlaits ERROR: mem alloc failed!\n");
+        return;
+    }
+    cmd->size = size;
+    cmd->sr = world->mSampleRate;
+    cmd->pool = NULL;
+    DoAsynchronousCommand(world, replyAddr, "miPlaitsPool", cmd,
+                          VoicePool_Create, VoicePool_Install, VoicePool_Dispose,
+                          VoicePool_FreeCommand, 0, 0);
+}
+
+
+static plaits::Voice* VoicePool_CheckOut(VoicePool *pool, float sr) {
+    if(pool == NULL || pool->num_free == 0 || pool->sr != sr)
+        return NULL;
+    PooledVoice *v = pool->free_voices[--pool->num_free];
+    // clears 32k and the engine state, as in a new voice: the engine is
+    // initialized again on the first block
+    memset(v->shared_buffer, 0, kSharedBufferSize);
+    v->voice.Reset();
+    return &v->voice;
+}
+
+static void VoicePool_Return(World *world, VoicePool *pool, plaits::Voice *voice) {
+    pool->free_voices[pool->num_free++] = (PooledVoice*)voice;
+    
+    if(pool->retired && pool->num_free == pool->size) {
+        PoolCommand *cmd = (PoolCommand*)RTAlloc(world, sizeof(PoolCommand));
+        if(cmd == NULL) {
+            Print("MiPlaits ERROR: mem alloc failed, leaking voice pool!\n");
+            return;
+        }
+        cmd->size = 0;
+        cmd->sr = 0.f;
+        cmd->pool = pool;
+        DoAsynchronousCommand(world, 0, 0, cmd,
+                              VoicePool_Dispose, 0, 0,
+                              VoicePool_FreeCommand, 0, 0);
+    }
+}
+
+
+#pragma mark ----- patch banks -----
+
+// DX7 banks for the six-op engines, read from a Buffer and unpacked on the NRT
+// thread by the 'miPlaitsBank' plugin command. The synths playing a bank
+// share it read-only; the list of banks is only touched on the RT thread.
+
+const int kSysExBankSize = plaits::kNumPatchesPerBank * plaits::fm::Patch::SYX_SIZE;
+const int kSysExHeaderSize = 6;
+
+struct PatchBank {
+    plaits::fm::Patch   patches[plaits::kNumPatchesPerBank];
+    int                 bufnum;
+    int                 refs;       // synths playing it
+    bool                retired;    // replaced, delete when no synth plays it
+    PatchBank           *next;
+};
+
+struct BankCommand {
+    int             bufnum;
+    PatchBank       *bank;
+};
+
+static PatchBank *gPatchBanks = NULL;
+
+
+// the bytes of a .syx file, loaded as signed or unsigned values
+static inline uint8_t SysExByte(float x) {
+    return static_cast<int>(x) & 0xff;
+}
+
+static bool PatchBank_Create(World *world, void *data) {       // NRT
+    BankCommand *cmd = (BankCommand*)data;
+    SndBuf *buf = world->mSndBufsNonRealTimeMirror + cmd->bufnum;
+    const float *bytes = buf->data;
+    int size = buf->samples;
+    if(bytes == NULL || size == 0)
+        return true;                // no data, removes the bank
+    
+    // a 32 voice bulk dump as saved from a DX7 (header, voice data, checksum
+    // and end of message), or the voice data alone
+    int offset;
+    if(size == kSysExBankSize)
+        offset = 0;
+    else if(size == kSysExHeaderSize + kSysExBankSize + 2
+            && SysExByte(bytes[0]) == 0xf0 && SysExByte(bytes[1]) == 0x43
+            && SysExByte(bytes[3]) == 0x09 && SysExByte(bytes[4]) == 0x20
+            && SysExByte(bytes[5]) == 0x00)
+        offset = kSysExHeaderSize;
+    else {
+        Print("MiPlaits ERROR: buffer %d doesn't hold a 32 voice DX7 bank!\n", cmd->bufnum);
+        return false;
+    }
+    
+    PatchBank *bank = (PatchBank*)malloc(sizeof(PatchBank));
+    if(bank == NULL) {
+        Print("MiPlaits ERROR: mem alloc failed, bank not loaded!\n");
+        return false;
+    }
+    uint8_t syx[plaits::fm::Patch::SYX_SIZE];
+    for(int i=0; i<plaits::kNumPatchesPerBank; ++i) {
+        const float *patch_bytes = bytes + offset + i * plaits::fm::Patch::SYX_SIZE;
+        for(int j=0; j<plaits::fm::Patch::SYX_SIZE; ++j)
+            syx[j] = SysExByte(patch_bytes[j]);
+        bank->patches[i].Unpack(syx);
+    }
+    bank->bufnum = cmd->bufnum;
+    bank->refs = 0;
+    bank->retired = false;
+    bank->next = NULL;
+    cmd->bank = bank;
+    return true;
+}
+
+static bool PatchBank_Install(World *world, void *data) {      // RT
+    BankCommand *cmd = (BankCommand*)data;
+    PatchBank *old = NULL;
+    for(PatchBank **b = &gPatchBanks; *b; b = &(*b)->next) {
+        if((*b)->bufnum == cmd->bufnum) {
+            old = *b;
+            *b = old->next;
+            break;
+        }
+    }
+    if(cmd->bank) {
+        cmd->bank->next = gPatchBanks;
+        gPatchBanks = cmd->bank;
+    }
+    cmd->bank = NULL;
+    if(old) {
+        if(old->refs == 0)
+            cmd->bank = old;        // delete it right away
+        else
+            old->retired = true;    // synths are still playing it
+    }
+    return true;
+}
+
+static bool PatchBank_Dispose(World *world, void *data) {      // NRT
+    BankCommand *cmd = (BankCommand*)data;
+    free(cmd->bank);
+    return true;
+}
+
+static void PatchBank_FreeCommand(World *world, void *data) {  // RT
+    RTFree(world, data);
+}
+
+
+// /cmd miPlaitsBank <bufnum>
+// Unpacks the DX7 bank held by Buffer <bufnum>, for the synths whose 'bank'
+// input is <bufnum>. Sending it again replaces the bank with the Buffer's new
+// contents, an empty Buffer removes it. Replies /done miPlaitsBank once the
+// bank is in use.
+static void PatchBank_Cmd(World *world, void *inUserData, struct sc_msg_iter *args, void *replyAddr) {
+    
+    int bufnum = args->geti(-1);
+    if(bufnum < 0 || bufnum >= (int)world->mNumSndBufs) {
+        Print("MiPlaits ERROR: invalid buffer number %d!\n", bufnum);
+        return;
+    }
+    
+    BankCommand *cmd = (BankCommand*)RTAlloc(world, sizeof(BankCommand));
+    if(cmd == NULL) {
+        Print("MiPlaits ERROR: mem alloc failed!\n");
+        return;
+    }
+    cmd->bufnum = bufnum;
+    cmd->bank = NULL;
+    DoAsynchronousCommand(world, replyAddr, "miPlaitsBank", cmd,
+                          PatchBank_Create, PatchBank_Install, PatchBank_Dispose,
+                          PatchBank_FreeCommand, 0, 0);
+}
+
+
+// Moves a synth to the bank loaded for bufnum (none if negative), if it isn't
+// playing it yet or if the bank it plays was replaced. The bank it played so
+// far is returned in previous, to be released once its voices have rendered
+// a block with the new one.
+static bool PatchBank_Update(PatchBank **bank, PatchBank **previous, int bufnum) {
+    PatchBank *current = *bank;
+    *previous = NULL;
+    if(current && !current->retired && current->bufnum == bufnum)
+        return false;
+    
+    PatchBank *found = NULL;
+    if(bufnum >= 0) {
+        for(PatchBank *b = gPatchBanks; b; b = b->next) {
+            if(b->bufnum == bufnum) {
+                found = b;
+                break;
+            }
+        }
+    }
+    if(found == current)
+        return false;
+    
+    if(found)
+        ++found->refs;
+    *bank = found;
+    *previous = current;
+    return true;
+}
+
+static const plaits::fm::Patch* PatchBank_Patches(PatchBank *bank) {
+    return bank ? bank->patches : NULL;
+}
+
+// the buffer number of the bank to play, -1 for the built-in ones
+static inline int MiPlaits_BankInput(Unit *unit, uint32 index) {
+    return unit->mNumInputs > index ? static_cast<int>(IN0(index)) : -1;
+}
+
+static void PatchBank_Release(World *world, PatchBank *bank) {
+    if(--bank->refs > 0 || !bank->retired)
+        return;
+    
+    BankCommand *cmd = (BankCommand*)RTAlloc(world, sizeof(BankCommand));
+    if(cmd == NULL) {
+        Print("MiPlaits ERROR: mem alloc failed, leaking patch bank!\n");
+        return;
+    }
+    cmd->bufnum = bank->bufnum;
+    cmd->bank = bank;
+    DoAsynchronousCommand(world, 0, 0, cmd,
+                          PatchBank_Dispose, 0, 0,
+                          PatchBank_FreeCommand, 0, 0);
+}
+
+
+#pragma mark ----- engine memory -----
+
+// Bytes of the shared buffer taken by each engine, measured once when the
+// plugin is loaded. A synth with a fixed engine only allocates what it needs.
+
+static size_t gEngineMemory[plaits::kMaxEngines];
+
+static void MeasureEngineMemory() {
+    
+    for(int i=0; i<plaits::kMaxEngines; ++i)
+        gEngineMemory[i] = kSharedBufferSize;
+    
+    char *buffer = (char*)calloc(1, kSharedBufferSize);
+    plaits::Voice *voice = (plaits::Voice*)calloc(1, sizeof(plaits::Voice));
+    if(buffer && voice) {
+        stmlib::BufferAllocator allocator(buffer, kSharedBufferSize);
+        new(voice) plaits::Voice;
+        voice->Init(&allocator, 48000.f);
+        for(int i=0; i<plaits::kMaxEngines; ++i)
+            gEngineMemory[i] = voice->InitEngine(i);
+        voice->~Voice();
+    }
+    free(voice);
+    free(buffer);
+}
+
+
+#pragma mark ----- voice slots -----
+
+// Shared memory for the engine selected by a given input: a constant engine
+// input can't switch to an engine needing more memory.
+static size_t MiPlaits_BufferSize(Unit *unit, int engine_input) {
+    if (INRATE(engine_input) != calc_ScalarRate)
+        return kSharedBufferSize;
+    
+    int engine = int(IN0(engine_input));
+    CONSTRAIN(engine, 0, plaits::kMaxEngines - 1);
+    size_t buffer_size = (gEngineMemory[engine] + 15) & ~15;
+    return buffer_size ? buffer_size : 16;
+}
+
+// Takes a ready-made voice from the pool if there is one left, or allocates
+// and initializes one with buffer_size bytes of shared memory.
+static bool VoiceSlot_Init(VoiceSlot *slot, World *world, float sr, size_t buffer_size) {
+    
+    slot->shared_buffer = NULL;
+    slot->voice = VoicePool_CheckOut(gVoicePool, sr);
+    slot->pool = slot->voice ? gVoicePool : NULL;
+    if(slot->voice)
+        return true;
+    
+    // allocate memory
+    slot->shared_buffer = (char*)RTAlloc(world, buffer_size);
+    slot->voice = (plaits::Voice*)RTAlloc(world, sizeof(plaits::Voice));
+    
+    if(slot->shared_buffer == NULL || slot->voice == NULL) {
+        if(slot->voice) {
+            RTFree(world, slot->voice);
+            slot->voice = NULL;
+        }
+        return false;
+    }
+    // init with zeros
+    memset(slot->shared_buffer, 0, buffer_size);
+    memset(slot->voice, 0, sizeof(plaits::Voice));
+    slot->allocator.Init(slot->shared_buffer, buffer_size);
+    
+    new(slot->voice) plaits::Voice;
+    slot->voice->Init(&slot->allocator, sr);
+    return true;
+}
+
+static void VoiceSlot_Free(VoiceSlot *slot, World *world) {
+    if(slot->pool) {
+        VoicePool_Return(world, slot->pool, slot->voice);
+    }
+    else if(slot->voice) {
+        slot->voice->~Voice();
+        RTFree(world, slot->voice);
+    }
+    if(slot->shared_buffer) {
+        RTFree(world, slot->shared_buffer);
+    }
+    slot->voice = NULL;
+    slot->shared_buffer = NULL;
+    slot->pool = NULL;
+}
+
+
+#pragma mark ----- ctor/dtor -----
 
 static void MiPlaits_Ctor(MiPlaits *unit) {
     
+    unit->slot.voice = NULL;
+    unit->slot.shared_buffer = NULL;
+    unit->slot.pool = NULL;
+    unit->bank = NULL;
+    
     if (BUFLENGTH < kBlockSize) {
         Print("MiPlaits ERROR: block size can't be smaller than %d samples!\n", kBlockSize);
-        unit = NULL;
+        SETCALC(ClearUnitOutputs);
+        ClearUnitOutputs(unit, 1);
         return;
     }
     
-    kSampleRate = SAMPLERATE;
-    a0 = (440.0f / 8.0f) / kSampleRate;
-
+    uint32_t seed = unit->mNumInputs > 12 ? static_cast<int32_t>(IN0(12)) : 0;
+    unit->rng_state = seed ? seed : unit->mParent->mRGen->trand();
+    stmlib::ScopedRandomState rng(&unit->rng_state);
+    
     // init some params
     unit->transposition_ = 0.;
     unit->octave_ = 0.5;
@@ -89,19 +585,17 @@ static void MiPlaits_Ctor(MiPlaits *unit) {
     unit->patch.morph_modulation_amount = 0.0;
         
     
-    // allocate memory
-    unit->shared_buffer = (char*)RTAlloc(unit->mWorld, 32768);
-    // init with zeros
-    memset(unit->shared_buffer, 0, 32768);
-
-    if(unit->shared_buffer == NULL) {
+    if(!VoiceSlot_Init(&unit->slot, unit->mWorld, SAMPLERATE, MiPlaits_BufferSize(unit, 1))) {
         Print("MiPlaits ERROR: mem alloc failed!");
-        unit = NULL;
+        SETCALC(ClearUnitOutputs);
+        ClearUnitOutputs(unit, 1);
+        return;
     }
-    stmlib::BufferAllocator allocator(unit->shared_buffer, 32768);
-
-    unit->voice_ = new plaits::Voice;
-    unit->voice_->Init(&allocator);
+    
+    // DX7 bank of the six-op engines, none plays the built-in ones
+    PatchBank *previous;
+    PatchBank_Update(&unit->bank, &previous, MiPlaits_BankInput(unit, 13));
+    unit->slot.voice->set_fm_patches(PatchBank_Patches(unit->bank));
     
     
     memset(&unit->patch, 0, sizeof(unit->patch));
@@ -124,11 +618,9 @@ static void MiPlaits_Ctor(MiPlaits *unit) {
 
 
 static void MiPlaits_Dtor(MiPlaits *unit) {
-    
-    delete unit->voice_;
-    if(unit->shared_buffer) {
-        RTFree(unit->mWorld, unit->shared_buffer);
-    }
+    VoiceSlot_Free(&unit->slot, unit->mWorld);
+    if(unit->bank)
+        PatchBank_Release(unit->mWorld, unit->bank);
 }
 
 
@@ -136,6 +628,8 @@ static void MiPlaits_Dtor(MiPlaits *unit) {
 
 void MiPlaits_next( MiPlaits *unit, int inNumSamples)
 {
+    stmlib::ScopedRandomState rng(&unit->rng_state);
+    
     float voct = IN0(0);
     float engine_in = IN0(1);
     
@@ -152,6 +646,10 @@ void MiPlaits_next( MiPlaits *unit, int inNumSamples)
     
     float *out = OUT(0);
     float *aux = OUT(1);
+    
+    PatchBank *previous_bank;
+    if(PatchBank_Update(&unit->bank, &previous_bank, MiPlaits_BankInput(unit, 13)))
+        unit->slot.voice->set_fm_patches(PatchBank_Patches(unit->bank));
 
     
     // TODO: check setting pitch
@@ -219,17 +717,226 @@ void MiPlaits_next( MiPlaits *unit, int inNumSamples)
     
     for(int count = 0; count < inNumSamples; count += kBlockSize) {
         
-        unit->voice_->Render(unit->patch, unit->modulations, out+count, aux+count, kBlockSize);
+        MI_PROFILE_SCOPE(gProfiler, unit->patch.engine, kBlockSize);
+        unit->slot.voice->Render(unit->patch, unit->modulations, out+count, aux+count, kBlockSize);
+
+    }
+    
+    // the voice doesn't read the patches of the previous bank anymore
+    if(previous_bank)
+        PatchBank_Release(unit->mWorld, previous_bank);
+    
+}
 
+
+
+#pragma mark ----- polyphonic -----
+
+static void MiPlaitsPoly_Ctor(MiPlaitsPoly *unit) {
+    
+    unit->voices = NULL;
+    unit->num_voices = 0;
+    unit->bank = NULL;
+    
+    if (BUFLENGTH < kBlockSize) {
+        Print("MiPlaitsPoly ERROR: block size can't be smaller than %d samples!\n", kBlockSize);
+        SETCALC(ClearUnitOutputs);
+        ClearUnitOutputs(unit, 1);
+        return;
+    }
+    
+    int num_inputs = IN0(0);
+    if (num_inputs < 1 || (int)unit->mNumInputs < kPolyVoiceInputs + 3 * num_inputs) {
+        Print("MiPlaitsPoly ERROR: wrong number of inputs!\n");
+        SETCALC(ClearUnitOutputs);
+        ClearUnitOutputs(unit, 1);
+        return;
+    }
+    unit->num_inputs = num_inputs;
+    int num_voices = std::min(num_inputs, kMaxPolyVoices);
+    if (num_voices < num_inputs)
+        Print("MiPlaitsPoly: only the first %d voices are played\n", kMaxPolyVoices);
+    
+    uint32_t seed = static_cast<int32_t>(IN0(10));
+    unit->rng_state = seed ? seed : unit->mParent->mRGen->trand();
+    stmlib::ScopedRandomState rng(&unit->rng_state);
+    
+    unit->voices = (PolyVoice*)RTAlloc(unit->mWorld, num_voices * sizeof(PolyVoice));
+    if(unit->voices == NULL) {
+        Print("MiPlaitsPoly ERROR: mem alloc failed!\n");
+        SETCALC(ClearUnitOutputs);
+        ClearUnitOutputs(unit, 1);
+        return;
+    }
+    
+    size_t buffer_size = MiPlaits_BufferSize(unit, 1);
+    for(int v=0; v<num_voices; ++v) {
+        PolyVoice *voice = &unit->voices[v];
+        if(!VoiceSlot_Init(&voice->slot, unit->mWorld, SAMPLERATE, buffer_size)) {
+            Print("MiPlaitsPoly ERROR: mem alloc failed!\n");
+            SETCALC(ClearUnitOutputs);
+            ClearUnitOutputs(unit, 1);
+            return;
+        }
+        unit->num_voices = v + 1;
+        
+        memset(&voice->modulations, 0, sizeof(voice->modulations));
+        voice->modulations.timbre_patched = (INRATE(3) != calc_ScalarRate);
+        voice->modulations.morph_patched = (INRATE(4) != calc_ScalarRate);
+        voice->modulations.trigger_patched = (INRATE(kPolyVoiceInputs + num_inputs + v) != calc_ScalarRate);
+        voice->modulations.level_patched = (INRATE(kPolyVoiceInputs + 2 * num_inputs + v) != calc_ScalarRate);
+        voice->modulations.frequency_patched = false;
+        voice->note = 0.f;
+    }
+    
+    memset(&unit->patch, 0, sizeof(unit->patch));
+    
+    // all voices play the same DX7 bank
+    PatchBank *previous;
+    PatchBank_Update(&unit->bank, &previous, MiPlaits_BankInput(unit, 11));
+    for(int v=0; v<num_voices; ++v)
+        unit->voices[v].slot.voice->set_fm_patches(PatchBank_Patches(unit->bank));
+    
+    SETCALC(MiPlaitsPoly_next);
+}
+
+
+static void MiPlaitsPoly_Dtor(MiPlaitsPoly *unit) {
+    
+    for(int v=0; v<unit->num_voices; ++v)
+        VoiceSlot_Free(&unit->voices[v].slot, unit->mWorld);
+    if(unit->voices) {
+        RTFree(unit->mWorld, unit->voices);
+    }
+    if(unit->bank)
+        PatchBank_Release(unit->mWorld, unit->bank);
+}
+
+
+void MiPlaitsPoly_next( MiPlaitsPoly *unit, int inNumSamples)
+{
+    stmlib::ScopedRandomState rng(&unit->rng_state);
+    
+    // the patch is shared, so it's only parsed once for all voices
+    float engine_in = IN0(1);
+    float harm_in = IN0(2);
+    float timbre_in = IN0(3);
+    float morph_in = IN0(4);
+    float fm_mod = IN0(5);
+    float timb_mod = IN0(6);
+    float morph_mod = IN0(7);
+    float decay_in = IN0(8);
+    float lpgColor_in = IN0(9);
+    
+    float *out = OUT(0);
+    float *aux = OUT(1);
+    
+    plaits::Patch *patch = &unit->patch;
+    
+    PatchBank *previous_bank;
+    if(PatchBank_Update(&unit->bank, &previous_bank, MiPlaits_BankInput(unit, 11))) {
+        for(int v=0; v<unit->num_voices; ++v)
+            unit->voices[v].slot.voice->set_fm_patches(PatchBank_Patches(unit->bank));
+    }
+    
+    int engine = int(engine_in);
+    CONSTRAIN(engine, 0, 23);      // 24 engines
+    patch->engine = engine;
+    
+    CONSTRAIN(harm_in, 0.0f, 1.0f);
+    patch->harmonics = harm_in;
+    
+    CONSTRAIN(timbre_in, 0.0f, 1.0f);
+    patch->timbre = timbre_in;
+    
+    CONSTRAIN(morph_in, 0.0f, 1.0f);
+    patch->morph = morph_in;
+    
+    CONSTRAIN(fm_mod, -1.0f, 1.0f);
+    patch->frequency_modulation_amount = fm_mod;
+    
+    CONSTRAIN(timb_mod, -1.0f, 1.0f);
+    patch->timbre_modulation_amount = timb_mod;
+    
+    CONSTRAIN(morph_mod, -1.0f, 1.0f);
+    patch->morph_modulation_amount = morph_mod;
+    
+    CONSTRAIN(decay_in, 0.0f, 1.0f);
+    patch->decay = decay_in;
+    
+    CONSTRAIN(lpgColor_in, 0.0f, 1.0f);
+    patch->lpg_colour = lpgColor_in;
+    
+    // per-voice inputs
+    const int num_voices = unit->num_voices;
+    const int num_inputs = unit->num_inputs;
+    
+    for(int v=0; v<num_voices; ++v) {
+        PolyVoice *voice = &unit->voices[v];
+        const int pitch_idx = kPolyVoiceInputs + v;
+        const int trig_idx = pitch_idx + num_inputs;
+        const int level_idx = trig_idx + num_inputs;
+        
+        float pitch = fabs(IN0(pitch_idx));
+        CONSTRAIN(pitch, 0.f, 127.f);
+        voice->note = pitch;
+        
+        if (voice->modulations.trigger_patched) {
+            float sum = 0.f;
+            if (INRATE(trig_idx) == calc_FullRate) {
+                const float *trig_in = IN(trig_idx);
+                for(int i=0; i<inNumSamples; ++i)
+                    sum += trig_in[i];
+            }
+            else {
+                sum = IN0(trig_idx);
+            }
+            voice->modulations.trigger = sum;
+        }
+        
+        if (voice->modulations.level_patched)
+            voice->modulations.level = IN0(level_idx);
+    }
+    
+    // render all voices one block at a time, so that the tables of the
+    // engine stay in cache from one voice to the next
+    float voice_out[kBlockSize];
+    float voice_aux[kBlockSize];
+    
+    for(int count = 0; count < inNumSamples; count += kBlockSize) {
+        
+        for(int v=0; v<num_voices; ++v) {
+            PolyVoice *voice = &unit->voices[v];
+            patch->note = voice->note;
+            
+            MI_PROFILE_SCOPE(gPolyProfiler, patch->engine, kBlockSize);
+            if (v == 0) {
+                voice->slot.voice->Render(*patch, voice->modulations, out+count, aux+count, kBlockSize);
+            }
+            else {
+                voice->slot.voice->Render(*patch, voice->modulations, voice_out, voice_aux, kBlockSize);
+                for(size_t i=0; i<kBlockSize; ++i) {
+                    out[count + i] += voice_out[i];
+                    aux[count + i] += voice_aux[i];
+                }
+            }
+        }
     }
     
+    if(previous_bank)
+        PatchBank_Release(unit->mWorld, previous_bank);
 }
 
 
 
 PluginLoad(MiPlaits) {
     ft = inTable;
+    MeasureEngineMemory();
     DefineDtorUnit(MiPlaits);
+    DefineDtorUnit(MiPlaitsPoly);
+    DefinePlugInCmd("miPlaitsPool", VoicePool_Cmd, 0);
+    DefinePlugInCmd("miPlaitsBank", PatchBank_Cmd, 0);
+    MI_PROFILE_COMMAND("miPlaitsProfile");
 }
 
 
@@ -0,0 +1,286 @@
+/*
+ mi-UGens - SuperCollider UGen Library
+ Copyright (c) 2026 The mi-UGens contributors.
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see http://www.gnu.org/licenses/ .
+ */
+
+/*
+
+ MiProfile - time spent in the dsp calls of the mi-UGens
+
+ Only compiled in with -DMI_PROFILE=ON. Each plug-in declares a profiler per
+ UGen with MI_PROFILER, and wraps its hot calls in MI_PROFILE_SCOPE: the
+ cycle counter is read before and after the call, and the difference goes to
+ a ring holding the last kProfileHistory calls of each mode (engine, model,
+ ...). Writing to the ring is lock-free, so the audio thread (or a worker
+ thread) never waits for the reader.
+
+ The plug-in command defined with MI_PROFILE_COMMAND prints min / mean /
+ percentiles / max of these calls, in microseconds, to the post window or
+ appends them to a file:
+
+    /cmd <command> [path] [reset]
+
+ Without MI_PROFILE the macros expand to nothing and the command only tells
+ that profiling isn't built in.
+
+ Include it after the plug-in's 'static InterfaceTable *ft', which the
+ command uses.
+
+ */
+
+#pragma once
+
+#include "SC_PlugIn.h"
+
+#ifdef MI_PROFILE
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define MI_PROFILE_RDTSC
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define MI_PROFILE_RDTSC
+#endif
+
+
+const int kProfileHistory = 1024;       // calls kept per mode
+
+
+static inline uint64_t MiProfile_Ticks() {
+#if defined(MI_PROFILE_RDTSC)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t ticks;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// microseconds per tick, measured once against the steady clock (NRT)
+static double MiProfile_TickPeriod() {
+    static double period = 0.0;
+    if(period == 0.0) {
+#if defined(MI_PROFILE_RDTSC)
+        auto start = std::chrono::steady_clock::now();
+        uint64_t start_ticks = MiProfile_Ticks();
+        std::chrono::duration<double, std::micro> elapsed;
+        do {
+            elapsed = std::chrono::steady_clock::now() - start;
+        } while(elapsed.count() < 20000.0);
+        period = elapsed.count() / (double)(MiProfile_Ticks() - start_ticks);
+#elif defined(__aarch64__)
+        uint64_t frequency;
+        asm volatile("mrs %0, cntfrq_el0" : "=r"(frequency));
+        period = 1e6 / (double)frequency;
+#else
+        period = 0.001;
+#endif
+    }
+    return period;
+}
+
+
+struct MiProfiler {
+
+    MiProfiler(const char *unit_name, const char *mode_name, int num_modes,
+               std::atomic<uint32_t> *times, std::atomic<uint32_t> *counts,
+               std::atomic<uint64_t> *samples, std::atomic<uint64_t> *ticks) :
+        unit_name(unit_name), mode_name(mode_name), num_modes(num_modes),
+        times(times), counts(counts), samples(samples), ticks(ticks) {
+        next = List();
+        List() = this;
+    }
+
+    // all the profilers of the plug-in
+    static MiProfiler*& List() {
+        static MiProfiler *list = NULL;
+        return list;
+    }
+
+    void Record(int mode, uint64_t elapsed, int num_samples) {
+        mode = std::max(0, std::min(mode, num_modes - 1));
+        uint32_t index = counts[mode].fetch_add(1, std::memory_order_relaxed);
+        times[mode * kProfileHistory + index % kProfileHistory].store(
+            (uint32_t)std::min<uint64_t>(elapsed, UINT32_MAX), std::memory_order_relaxed);
+        samples[mode].fetch_add(num_samples, std::memory_order_relaxed);
+        ticks[mode].fetch_add(elapsed, std::memory_order_relaxed);
+    }
+
+    void Reset() {
+        for(int i=0; i<num_modes; ++i) {
+            counts[i].store(0, std::memory_order_relaxed);
+            samples[i].store(0, std::memory_order_relaxed);
+            ticks[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void Report(FILE *file) {
+        double period = MiProfile_TickPeriod();
+        uint32_t sorted[kProfileHistory];
+
+        for(int mode=0; mode<num_modes; ++mode) {
+            uint32_t count = counts[mode].load(std::memory_order_relaxed);
+            if(count == 0)
+                continue;
+            int n = std::min<uint32_t>(count, kProfileHistory);
+            for(int i=0; i<n; ++i)
+                sorted[i] = times[mode * kProfileHistory + i].load(std::memory_order_relaxed);
+            std::sort(sorted, sorted + n);
+
+            double sum = 0.0;
+            for(int i=0; i<n; ++i)
+                sum += sorted[i];
+            uint64_t num_samples = samples[mode].load(std::memory_order_relaxed);
+            double ns_per_sample = num_samples ?
+                ticks[mode].load(std::memory_order_relaxed) * period * 1000.0 / num_samples : 0.0;
+
+            char label[64];
+            if(num_modes > 1)
+                snprintf(label, sizeof(label), "%s %s %d", unit_name, mode_name, mode);
+            else
+                snprintf(label, sizeof(label), "%s", unit_name);
+
+            char line[256];
+            snprintf(line, sizeof(line),
+                     "%s: %u calls, min %.2f mean %.2f p50 %.2f p95 %.2f p99 %.2f max %.2f us, %.1f ns/sample\n",
+                     label, count,
+                     sorted[0] * period, sum / n * period,
+                     sorted[n / 2] * period, sorted[n * 95 / 100] * period,
+                     sorted[n * 99 / 100] * period, sorted[n - 1] * period,
+                     ns_per_sample);
+            if(file)
+                fputs(line, file);
+            else
+                Print("%s", line);
+        }
+    }
+
+    const char              *unit_name;
+    const char              *mode_name;
+    int                     num_modes;
+    std::atomic<uint32_t>   *times;     // num_modes rings of kProfileHistory calls
+    std::atomic<uint32_t>   *counts;    // calls per mode since the last reset
+    std::atomic<uint64_t>   *samples;
+    std::atomic<uint64_t>   *ticks;
+    MiProfiler              *next;
+};
+
+
+struct MiProfileScope {
+    MiProfileScope(MiProfiler &profiler, int mode, int num_samples) :
+        profiler(profiler), mode(mode), num_samples(num_samples), start(MiProfile_Ticks()) { }
+    ~MiProfileScope() {
+        profiler.Record(mode, MiProfile_Ticks() - start, num_samples);
+    }
+    MiProfiler  &profiler;
+    int         mode;
+    int         num_samples;
+    uint64_t    start;
+};
+
+
+struct ProfileCommand {
+    bool    reset;
+    char    path[1];    // allocated with the length of the path
+};
+
+static bool MiProfile_Report(World *world, void *data) {       // NRT
+    ProfileCommand *cmd = (ProfileCommand*)data;
+    FILE *file = NULL;
+    if(cmd->path[0]) {
+        file = fopen(cmd->path, "a");
+        if(file == NULL) {
+            Print("MiProfile ERROR: can't open %s!\n", cmd->path);
+            return true;
+        }
+    }
+    for(MiProfiler *p = MiProfiler::List(); p; p = p->next)
+        p->Report(file);
+    if(file)
+        fclose(file);
+    return true;
+}
+
+static bool MiProfile_Reset(World *world, void *data) {        // RT
+    ProfileCommand *cmd = (ProfileCommand*)data;
+    if(cmd->reset) {
+        for(MiProfiler *p = MiProfiler::List(); p; p = p->next)
+            p->Reset();
+    }
+    return true;
+}
+
+static void MiProfile_FreeCommand(World *world, void *data) {  // RT
+    RTFree(world, data);
+}
+
+static void MiProfile_Cmd(World *world, void *inUserData, struct sc_msg_iter *args, void *replyAddr) {
+
+    const char *path = args->gets("");
+    bool reset = args->geti(0) != 0;
+
+    size_t length = strlen(path);
+    ProfileCommand *cmd = (ProfileCommand*)RTAlloc(world, sizeof(ProfileCommand) + length);
+    if(cmd == NULL) {
+        Print("MiProfile ERROR: mem alloc failed!\n");
+        return;
+    }
+    cmd->reset = reset;
+    memcpy(cmd->path, path, length + 1);
+    DoAsynchronousCommand(world, replyAddr, (const char*)inUserData, cmd,
+                          MiProfile_Report, MiProfile_Reset, 0,
+                          MiProfile_FreeCommand, 0, 0);
+}
+
+
+// one profiler per UGen: unit and mode names for the report, number of modes
+#define MI_PROFILER(name, unit_name, mode_name, num_modes) \
+    static std::atomic<uint32_t> name##_times[(num_modes) * kProfileHistory]; \
+    static std::atomic<uint32_t> name##_counts[num_modes]; \
+    static std::atomic<uint64_t> name##_samples[num_modes]; \
+    static std::atomic<uint64_t> name##_ticks[num_modes]; \
+    static MiProfiler name(unit_name, mode_name, num_modes, \
+                           name##_times, name##_counts, name##_samples, name##_ticks)
+
+// times the rest of the enclosing block, which renders num_samples samples
+#define MI_PROFILE_SCOPE(name, mode, num_samples) \
+    MiProfileScope mi_profile_scope(name, mode, num_samples)
+
+#else   // MI_PROFILE
+
+#define MI_PROFILER(name, unit_name, mode_name, num_modes)
+#define MI_PROFILE_SCOPE(name, mode, num_samples)
+
+static void MiProfile_Cmd(World *world, void *inUserData, struct sc_msg_iter *args, void *replyAddr) {
+    Print("%s: mi-UGens built without profiling (-DMI_PROFILE=ON)\n", (const char*)inUserData);
+}
+
+#endif  // MI_PROFILE
+
+
+// /cmd <name> [path] [reset]
+#define MI_PROFILE_COMMAND(name) \
+    DefinePlugInCmd(name, MiProfile_Cmd, (void*)name)
@@ -34,14 +34,21 @@
 #include "rings/dsp/strummer.h"
 #include "rings/dsp/string_synth_part.h"
 #include "rings/dsp/dsp.h"
+#include "stmlib/dsp/silence_detector.h"
+#include "stmlib/utils/random.h"
 
 
-float rings::Dsp::sr = 48000.0f;
-float rings::Dsp::a3 = 440.0f / 48000.0f;
 const size_t kBlockSize = rings::kMaxBlockSize;
 
+// a voice whose input and output stayed silent goes to sleep: the resonator
+// is left as it is until a strum or some input comes in, and resumes from there
+
 static InterfaceTable *ft;
 
+#include "MiProfile.h"     // needs ft
+
+MI_PROFILER(gProfiler, "MiRings", "model", 6);
+
 
 struct MiRings : public Unit {
     
@@ -51,13 +58,16 @@ struct MiRings : public Unit {
     rings::PerformanceState performance_state;
     rings::Patch            patch;
     
-    uint16_t                *reverb_buffer;
+    rings::FxBufferType     *reverb_buffer;
     float                   *silence;
     float                   *input;
     
     bool                    prev_trig;
     int                     prev_poly;
     
+    stmlib::SilenceDetector silence_detector;
+    
+    uint32_t                rng_state;
 };
 
 
@@ -68,22 +78,34 @@ static void MiRings_next(MiRings *unit, int inNumSamples);
 
 static void MiRings_Ctor(MiRings *unit) {
     
-    rings::Dsp::setSr(SAMPLERATE);
-
+    unit->reverb_buffer = NULL;
+    unit->silence = unit->input = NULL;
+    
     if (BUFLENGTH < kBlockSize) {
         Print("MiRings ERROR: sc block size too small!\n");
-        unit = NULL;
+        SETCALC(ClearUnitOutputs);
+        ClearUnitOutputs(unit, 1);
         return;
     }
     
-    // allocate memory + init with zeros
-    unit->reverb_buffer = (uint16_t*)RTAlloc(unit->mWorld, 32768*sizeof(uint16_t));
-    memset(unit->reverb_buffer, 0, 32768*sizeof(uint16_t));
+    uint32_t seed = unit->mNumInputs > 12 ? static_cast<int32_t>(IN0(12)) : 0;
+    unit->rng_state = seed ? seed : unit->mParent->mRGen->trand();
+    stmlib::ScopedRandomState rng(&unit->rng_state);
     
+    // allocate memory + init with zeros
+    unit->reverb_buffer = (rings::FxBufferType*)RTAlloc(unit->mWorld, 32768*sizeof(rings::FxBufferType));
     unit->silence = (float*)RTAlloc(unit->mWorld, BUFLENGTH*sizeof(float));
-    memset(unit->silence, 0, BUFLENGTH*sizeof(float));
-    
     unit->input = (float*)RTAlloc(unit->mWorld, BUFLENGTH*sizeof(float));
+    
+    if(unit->reverb_buffer == NULL || unit->silence == NULL || unit->input == NULL) {
+        Print("MiRings ERROR: mem alloc failed!\n");
+        SETCALC(ClearUnitOutputs);
+        ClearUnitOutputs(unit, 1);
+        return;
+    }
+    
+    memset(unit->reverb_buffer, 0, 32768*sizeof(rings::FxBufferType));
+    memset(unit->silence, 0, BUFLENGTH*sizeof(float));
     memset(unit->input, 0, BUFLENGTH*sizeof(float));
     
     // zero out...
@@ -91,9 +113,10 @@ static void MiRings_Ctor(MiRings *unit) {
     memset(&unit->part, 0, sizeof(unit->part));
     memset(&unit->string_synth, 0, sizeof(unit->string_synth));
 
-    unit->strummer.Init(0.01, rings::Dsp::getSr() / kBlockSize);
-    unit->part.Init(unit->reverb_buffer);
-    unit->string_synth.Init(unit->reverb_buffer);
+    float sr = SAMPLERATE;
+    unit->strummer.Init(0.01, sr);
+    unit->part.Init(unit->reverb_buffer, sr);
+    unit->string_synth.Init(unit->reverb_buffer, sr);
     
     unit->part.set_polyphony(1);
     unit->part.set_model(rings::RESONATOR_MODEL_MODAL);
@@ -105,6 +128,8 @@ static void MiRings_Ctor(MiRings *unit) {
     unit->performance_state.fm = 0.f;       // TODO: fm not used, maybe later...
     unit->prev_trig = false;
     
+    unit->silence_detector.Init(sr);
+    
     
     // check input rates
     if(INRATE(0) == calc_FullRate)
@@ -134,6 +159,12 @@ static void MiRings_Dtor(MiRings *unit) {
     if(unit->reverb_buffer) {
         RTFree(unit->mWorld, unit->reverb_buffer);
     }
+    if(unit->silence) {
+        RTFree(unit->mWorld, unit->silence);
+    }
+    if(unit->input) {
+        RTFree(unit->mWorld, unit->input);
+    }
 }
 
 
@@ -141,6 +172,8 @@ static void MiRings_Dtor(MiRings *unit) {
 
 void MiRings_next( MiRings *unit, int inNumSamples)
 {
+    stmlib::ScopedRandomState rng(&unit->rng_state);
+    
     float   *in = IN(0);
     float   *trig_in = IN(1);
     
@@ -243,23 +276,35 @@ void MiRings_next( MiRings *unit, int inNumSamples)
     unit->part.set_bypass(bypass);
     
     
-    if(easter_egg) {
-        for(int count=0; count<inNumSamples; count+=size) {
-            
-            unit->strummer.Process(NULL, size, ps);
-            unit->string_synth.Process(*ps, *patch,
-                                   input+count, out1+count, out2+count, size);
+    for(int count=0; count<inNumSamples; count+=size) {
+        
+        // the strummer keeps running while asleep, its strums wake us up
+        unit->strummer.Process(easter_egg ? NULL : input+count, size, ps);
+        
+        if(unit->silence_detector.asleep()) {
+            if(!ps->strum && stmlib::SilenceDetector::IsSilent(input+count, size)) {
+                memset(out1+count, 0, size*sizeof(float));
+                memset(out2+count, 0, size*sizeof(float));
+                continue;
+            }
+            unit->silence_detector.Wake();
         }
-    }
-    else {
-        for(int count=0; count<inNumSamples; count+=size) {
-            
-            unit->strummer.Process(input+count, size, ps);
+        
+        MI_PROFILE_SCOPE(gProfiler, model, size);
+        if(easter_egg)
+            unit->string_synth.Process(*ps, *patch,
+                                       input+count, out1+count, out2+count, size);
+        else
             unit->part.Process(*ps, *patch,
                                input+count, out1+count, out2+count, size);
-        }
     }
     
+    if(!unit->silence_detector.asleep()) {
+        bool silent = stmlib::SilenceDetector::IsSilent(input, inNumSamples) &&
+                      stmlib::SilenceDetector::IsSilent(out1, inNumSamples) &&
+                      stmlib::SilenceDetector::IsSilent(out2, inNumSamples);
+        unit->silence_detector.Process(silent, inNumSamples);
+    }
     
 }
 
@@ -267,6 +312,7 @@ void MiRings_next( MiRings *unit, int inNumSamples)
 PluginLoad(MiRings) {
     ft = inTable;
     DefineDtorUnit(MiRings);
+    MI_PROFILE_COMMAND("miRingsProfile");
 }
 
 
@@ -34,6 +34,8 @@
 
 #include "Ripples/ripples.hpp"
 
+#include <new>
+
 static InterfaceTable *ft;
 
 
@@ -55,7 +57,12 @@ static void MiRipples_next(MiRipples *unit, int inNumSamples);
 
 static void MiRipples_Ctor(MiRipples *unit) {
     
-    unit->engine = new ripples::RipplesEngine;
+    unit->engine = (ripples::RipplesEngine*)RTAlloc(unit->mWorld, sizeof(ripples::RipplesEngine));
+    if(unit->engine == NULL) {
+        Print("MiRipples ERROR: mem alloc failed!\n");
+        return;
+    }
+    new(unit->engine) ripples::RipplesEngine;
     unit->engine->setSampleRate(SAMPLERATE);
     
     unit->drive = 1.0;
@@ -73,8 +80,10 @@ static void MiRipples_Ctor(MiRipples *unit) {
 
 
 static void MiRipples_Dtor(MiRipples *unit) {
-    if(unit->engine)
-        delete unit->engine;
+    if(unit->engine) {
+        unit->engine->~RipplesEngine();
+        RTFree(unit->mWorld, unit->engine);
+    }
 }
 
 
@@ -42,6 +42,7 @@ static InterfaceTable *ft;
 
 const size_t kAudioBlockSize = 8;        // sig vs can't be smaller than this!
 const size_t kNumOutputs = 4;
+const int kNumParameters = 5;            // freq, shape, slope, smooth, shift
 
 static tides::Ratio kRatios[19] = {
     { 0.0625f, 16 },
@@ -93,6 +94,7 @@ struct MiTides : public Unit {
     float       shift, shift_lp;
     
     bool        must_reset_ramp_extractor;
+    bool        audio_rate[kNumParameters];     // parameter inputs
     
     float       sr;
     float       r_sr;
@@ -105,13 +107,15 @@ struct MiTides : public Unit {
 static void MiTides_Ctor(MiTides *unit);
 static void MiTides_Dtor(MiTides *unit);
 static void MiTides_next(MiTides *unit, int inNumSamples);
+static void MiTides_next_a(MiTides *unit, int inNumSamples);
 
 
 static void MiTides_Ctor(MiTides *unit) {
     
     if(BUFLENGTH < kAudioBlockSize) {
         Print("MiTides ERROR: Block Size can't be smaller than %d samples\n", kAudioBlockSize);
-        unit = NULL;
+        SETCALC(ClearUnitOutputs);
+        ClearUnitOutputs(unit, 1);
         return;
     }
     
@@ -149,7 +153,18 @@ static void MiTides_Ctor(MiTides *unit) {
     unit->r_.q = 1;
     
     
-    SETCALC(MiTides_next);
+    // audio rate parameters are rendered sample by sample, the others once
+    // per block
+    bool audio_rate = false;
+    for(int i=0; i<kNumParameters; ++i) {
+        unit->audio_rate[i] = (INRATE(i) == calc_FullRate);
+        audio_rate |= unit->audio_rate[i];
+    }
+    
+    if(audio_rate)
+        SETCALC(MiTides_next_a);
+    else
+        SETCALC(MiTides_next);
     ClearUnitOutputs(unit, 1);
     //MiTides_next(unit, 1);
     
@@ -165,15 +180,39 @@ static void MiTides_Dtor(MiTides *unit) {
 
 #pragma mark ----- dsp loop -----
 
-void MiTides_next( MiTides *unit, int inNumSamples )
+// One block of a parameter for the audio rate render: the audio rate input as
+// is, or the control rate one, smoothed as in MiTides_next and ramped over the
+// block.
+static inline void MiTides_Parameter(const float *in, bool audio_rate, float *lp, float *out) {
+    
+    if(audio_rate) {
+        for(int i=0; i<kAudioBlockSize; ++i) {
+            float value = in[i];
+            CONSTRAIN(value, 0.f, 1.f);
+            out[i] = value;
+        }
+    }
+    else {
+        float value = in[0];
+        CONSTRAIN(value, 0.f, 1.f);
+        float start = *lp;
+        ONE_POLE(*lp, value, 0.1f);
+        float increment = (*lp - start) * (1.f / kAudioBlockSize);
+        for(int i=0; i<kAudioBlockSize; ++i)
+            out[i] = start + increment * (i + 1);
+    }
+}
+
+
+template<bool audio_rate>
+static inline void MiTides_Render( MiTides *unit, int inNumSamples )
 {
-    // TODO: make these audio rate inputs
-    float   freq_in = IN0(0);
+    float   *freq_in = IN(0);
 
-    float   shape_in = IN0(1);
-    float   slope_in = IN0(2);
-    float   smooth_in = IN0(3);
-    float   shift_in = IN0(4);
+    float   *shape_in = IN(1);
+    float   *slope_in = IN(2);
+    float   *smooth_in = IN(3);
+    float   *shift_in = IN(4);
     
 
     float   *trig_in = IN(5);
@@ -209,7 +248,7 @@ void MiTides_next( MiTides *unit, int inNumSamples )
     
     float   frequency, shape, slope, shift, smoothness;
     
-//    float   freq_lp = unit->freq_lp;
+    float   freq_lp = unit->freq_lp;
     float   shape_lp = unit->shape_lp;
     float   slope_lp = unit->slope_lp;
     float   shift_lp = unit->shift_lp;
@@ -260,7 +299,7 @@ void MiTides_next( MiTides *unit, int inNumSamples )
 
         }
         else {
-            frequency = (freq_in) * r_sr;
+            frequency = (freq_in[0]) * r_sr;
             CONSTRAIN(frequency, 0.f, 0.4f);
             // no filtering for now
             //            ONE_POLE(freq_lp, frequency, 0.3f);
@@ -268,29 +307,65 @@ void MiTides_next( MiTides *unit, int inNumSamples )
             must_reset_ramp_extractor = true;
         }
 
-
-        // parameter inputs
-        shape = shape_in;
-        CONSTRAIN(shape, 0.f, 1.f);
-        ONE_POLE(shape_lp, shape, 0.1f);
-        slope = slope_in;
-        CONSTRAIN(slope, 0.f, 1.f);
-        ONE_POLE(slope_lp, slope, 0.1f);
-        smoothness = smooth_in;
-        CONSTRAIN(smoothness, 0.f, 1.f);
-        ONE_POLE(smooth_lp, smoothness, 0.1f);
-        shift = shift_in;
-        CONSTRAIN(shift, 0.f, 1.f);
-        ONE_POLE(shift_lp, shift, 0.1f);
-
-
-        unit->poly_slope_generator.Render(ramp_mode,
-                                          output_mode,
-                                          range,
-                                          frequency, slope_lp, shape_lp, smooth_lp, shift_lp,
-                                          gate_flags,
-                                          !use_trigger && use_clock ? ramp : NULL,
-                                          out, kAudioBlockSize);
+        if (audio_rate) {
+            
+            float frequency_block[kAudioBlockSize];
+            float shape_block[kAudioBlockSize];
+            float slope_block[kAudioBlockSize];
+            float smooth_block[kAudioBlockSize];
+            float shift_block[kAudioBlockSize];
+            
+            if (unit->audio_rate[0] && !use_clock) {
+                for(int i=0; i<kAudioBlockSize; ++i) {
+                    float f = freq_in[i + count] * r_sr;
+                    CONSTRAIN(f, 0.f, 0.4f);
+                    frequency_block[i] = f;
+                }
+            }
+            else {
+                float increment = (frequency - freq_lp) * (1.f / kAudioBlockSize);
+                for(int i=0; i<kAudioBlockSize; ++i)
+                    frequency_block[i] = freq_lp + increment * (i + 1);
+            }
+            freq_lp = frequency_block[kAudioBlockSize - 1];
+            
+            MiTides_Parameter(shape_in + count, unit->audio_rate[1], &shape_lp, shape_block);
+            MiTides_Parameter(slope_in + count, unit->audio_rate[2], &slope_lp, slope_block);
+            MiTides_Parameter(smooth_in + count, unit->audio_rate[3], &smooth_lp, smooth_block);
+            MiTides_Parameter(shift_in + count, unit->audio_rate[4], &shift_lp, shift_block);
+            
+            unit->poly_slope_generator.Render(ramp_mode,
+                                              output_mode,
+                                              range,
+                                              frequency_block, slope_block, shape_block, smooth_block, shift_block,
+                                              gate_flags,
+                                              !use_trigger && use_clock ? ramp : NULL,
+                                              out, kAudioBlockSize);
+        }
+        else {
+            // parameter inputs
+            shape = shape_in[0];
+            CONSTRAIN(shape, 0.f, 1.f);
+            ONE_POLE(shape_lp, shape, 0.1f);
+            slope = slope_in[0];
+            CONSTRAIN(slope, 0.f, 1.f);
+            ONE_POLE(slope_lp, slope, 0.1f);
+            smoothness = smooth_in[0];
+            CONSTRAIN(smoothness, 0.f, 1.f);
+            ONE_POLE(smooth_lp, smoothness, 0.1f);
+            shift = shift_in[0];
+            CONSTRAIN(shift, 0.f, 1.f);
+            ONE_POLE(shift_lp, shift, 0.1f);
+
+
+            unit->poly_slope_generator.Render(ramp_mode,
+                                              output_mode,
+                                              range,
+                                              frequency, slope_lp, shape_lp, smooth_lp, shift_lp,
+                                              gate_flags,
+                                              !use_trigger && use_clock ? ramp : NULL,
+                                              out, kAudioBlockSize);
+        }
         
 
         for(int i=0; i<kAudioBlockSize; ++i) {
@@ -301,7 +376,7 @@ void MiTides_next( MiTides *unit, int inNumSamples )
         
     }
     
-//    unit->freq_lp = freq_lp;
+    unit->freq_lp = freq_lp;
     unit->shape_lp = shape_lp;
     unit->shift_lp = shift_lp;
     unit->slope_lp = slope_lp;
@@ -312,6 +387,19 @@ void MiTides_next( MiTides *unit, int inNumSamples )
 }
 
 
+void MiTides_next( MiTides *unit, int inNumSamples )
+{
+    MiTides_Render<false>(unit, inNumSamples);
+}
+
+
+// with audio rate frequency, shape, slope, smoothness or shift
+void MiTides_next_a( MiTides *unit, int inNumSamples )
+{
+    MiTides_Render<true>(unit, inNumSamples);
+}
+
+
 
 
 PluginLoad(MiTides) {
@@ -32,57 +32,99 @@
 #include "SC_PlugIn.h"
 
 #include "reverb.h"
+#include "stmlib/dsp/silence_detector.h"
+
+#include <new>
 
 static InterfaceTable *ft;
 
 const uint16 kNumArgs = 6;
 
+// once the input is silent and the tail has decayed, the reverb sleeps until
+// some input comes in again
+
+#ifdef MIVERB_FLOAT_BUFFER
+const Format kBufferFormat = FORMAT_32_BIT;
+#else
+const Format kBufferFormat = FORMAT_16_BIT;
+#endif
+
 
 struct MiVerb : public Unit {
     
-    Reverb      reverb_;
-    uint16_t    *reverb_buffer;
+    void        *reverb_;
+    void        *reverb_buffer;
     float       input_gain;
     
+    stmlib::SilenceDetector silence_detector;
+    
 };
 
 
 static void MiVerb_Ctor(MiVerb *unit);
 static void MiVerb_Dtor(MiVerb *unit);
+template<int32_t sample_rate>
 static void MiVerb_next(MiVerb *unit, int inNumSamples);
 
 
-static void MiVerb_Ctor(MiVerb *unit) {
+// delay lines are scaled to the layout's sample rate, set up the one closest to ours
+template<int32_t sample_rate>
+static bool MiVerb_Init(MiVerb *unit) {
     
-    // alloc mem
-    unit->reverb_buffer = (uint16_t*)RTAlloc(unit->mWorld, 32768*sizeof(uint16_t));
-    memset(unit->reverb_buffer, 0, 32768*sizeof(uint16_t));
+    typedef Reverb<sample_rate, kBufferFormat> R;
     
-    if(unit->reverb_buffer == NULL) {
-        Print( "mem alloc failed!" );
-        unit = NULL;
-        ClearUnitOutputs(unit, BUFLENGTH); // ??
-        return;
-    }
+    unit->reverb_ = RTAlloc(unit->mWorld, sizeof(R));
+    unit->reverb_buffer = RTAlloc(unit->mWorld, R::buffer_size * sizeof(typename R::T));
+    if(unit->reverb_ == NULL || unit->reverb_buffer == NULL)
+        return false;
+    
+    memset(unit->reverb_, 0, sizeof(R));
+    R *reverb = new(unit->reverb_) R;
+    reverb->Init(static_cast<typename R::T*>(unit->reverb_buffer), SAMPLERATE);
+    
+    reverb->set_time(0.7f);
+    reverb->set_input_gain(unit->input_gain);
+    reverb->set_lp(0.3f);
+    reverb->set_amount(0.5f);
+    reverb->set_diffusion(0.625f);       // original value form Dattorro paper
 
+    reverb->set_hp(0.995f);
     
-    memset(&unit->reverb_, 0, sizeof(unit->reverb_));
-    unit->reverb_.Init(unit->reverb_buffer, SAMPLERATE);
+    SETCALC(MiVerb_next<sample_rate>);
+    return true;
+}
+
+
+static void MiVerb_Ctor(MiVerb *unit) {
+    
+    unit->reverb_ = NULL;
+    unit->reverb_buffer = NULL;
     
     unit->input_gain = 0.2f;
     
-    unit->reverb_.set_time(0.7f);
-    unit->reverb_.set_input_gain(unit->input_gain);
-    unit->reverb_.set_lp(0.3f);
-    unit->reverb_.set_amount(0.5f);
-    unit->reverb_.set_diffusion(0.625f);       // original value form Dattorro paper
-
-    unit->reverb_.set_hp(0.995f);
+    unit->silence_detector.Init(SAMPLERATE);
+    
+    float sr = SAMPLERATE;
+    bool ok;
+    if(sr < 38000.f)
+        ok = MiVerb_Init<32000>(unit);
+    else if(sr < 46000.f)
+        ok = MiVerb_Init<44100>(unit);
+    else if(sr < 72000.f)
+        ok = MiVerb_Init<48000>(unit);
+    else
+        ok = MiVerb_Init<96000>(unit);
+    
+    if(!ok) {
+        Print( "MiVerb ERROR: mem alloc failed!\n" );
+        SETCALC(ClearUnitOutputs);
+        ClearUnitOutputs(unit, 1);
+        return;
+    }
     
     //uint16 numAudioInputs = unit->mNumInputs - kNumArgs;
     //Print("MiVerb > numAudioIns: %d\n", numAudioInputs);
     
-    SETCALC(MiVerb_next);
     ClearUnitOutputs(unit, BUFLENGTH);
     //MiVerb_next(unit, BUFLENGTH);
     
@@ -91,6 +133,10 @@ static void MiVerb_Ctor(MiVerb *unit) {
 
 static void MiVerb_Dtor(MiVerb *unit) {
     
+    // the reverb objects are trivially destructible
+    if(unit->reverb_) {
+        RTFree(unit->mWorld, unit->reverb_);
+    }
     if(unit->reverb_buffer) {
         RTFree(unit->mWorld, unit->reverb_buffer);
     }
@@ -99,11 +145,12 @@ static void MiVerb_Dtor(MiVerb *unit) {
 
 
 
-void unit_freeze(MiVerb *unit) {
+template<typename R>
+void unit_freeze(R *reverb) {
    
-    unit->reverb_.set_time(1.0);
-    unit->reverb_.set_input_gain(0.0);
-    unit->reverb_.set_lp(1.0);
+    reverb->set_time(1.0);
+    reverb->set_input_gain(0.0);
+    reverb->set_lp(1.0);
     
 }
 
@@ -143,6 +190,7 @@ inline float SoftClip(float x) {
 
 #pragma mark ----- dsp loop -----
 
+template<int32_t sample_rate>
 void MiVerb_next( MiVerb *unit, int inNumSamples )
 {
     float   time = IN0(0);
@@ -156,11 +204,25 @@ void MiVerb_next( MiVerb *unit, int inNumSamples )
     float   *outR = OUT(1);
     
     size_t size = inNumSamples;
-    Reverb *reverb = &unit->reverb_;
+    Reverb<sample_rate, kBufferFormat> *reverb =
+        static_cast<Reverb<sample_rate, kBufferFormat>*>(unit->reverb_);
     
     // find out number of audio inputs
     uint16 numAudioInputs = unit->mNumInputs - kNumArgs;
     
+    // read before the outputs, which may share the buffers of the inputs
+    bool silent_input = true;
+    for(int i=0; i<numAudioInputs && silent_input; ++i)
+        silent_input = stmlib::SilenceDetector::IsSilent(IN(i+kNumArgs), inNumSamples);
+    
+    if(unit->silence_detector.asleep()) {
+        if(silent_input) {
+            ClearUnitOutputs(unit, inNumSamples);
+            return;
+        }
+        unit->silence_detector.Wake();
+    }
+    
     
     if(numAudioInputs == 1)
         Copy(inNumSamples, OUT(1), IN(kNumArgs));
@@ -174,7 +236,7 @@ void MiVerb_next( MiVerb *unit, int inNumSamples )
 
     
     if(freeze) {
-        unit_freeze(unit);
+        unit_freeze(reverb);
         // if 'freeze' is on, we want no direct signal // hm, rather not...
         //memset(outL, 0, size*sizeof(float));
         //memset(outR, 0, size*sizeof(float));
@@ -204,6 +266,10 @@ void MiVerb_next( MiVerb *unit, int inNumSamples )
     
     SoftClip_block(outL, size);
     SoftClip_block(outR, size);
+    
+    bool silent = silent_input && stmlib::SilenceDetector::IsSilent(outL, size) &&
+                  stmlib::SilenceDetector::IsSilent(outR, size);
+    unit->silence_detector.Process(silent, size);
 
 }
 
@@ -34,12 +34,59 @@
 #include "fx_engine.h"
 
 
+// Delay lines of the reverb are specified in samples at 32kHz. The layout for
+// another sample rate scales them, and picks the smallest power of two that
+// holds them all.
+template<int32_t sample_rate>
+struct ReverbLayout {
+  template<int32_t length>
+  struct Scale {
+    enum {
+      value = (length * sample_rate + 16000) / 32000
+    };
+  };
+  
+  template<int32_t n, int32_t size = 1, bool fits = (size >= n)>
+  struct PowerOfTwo {
+    enum {
+      value = PowerOfTwo<n, size * 2>::value
+    };
+  };
+  
+  template<int32_t n, int32_t size>
+  struct PowerOfTwo<n, size, true> {
+    enum {
+      value = size
+    };
+  };
+  
+  enum {
+    // Each line takes one more cell than its length.
+    memory_size = PowerOfTwo<
+        Scale<150>::value + Scale<214>::value + Scale<319>::value +
+        Scale<527>::value + Scale<2182>::value + Scale<2690>::value +
+        Scale<4501>::value + Scale<2525>::value + Scale<2197>::value +
+        Scale<6312>::value + 10>::value
+  };
+};
+
+template<int32_t sample_rate, Format format = FORMAT_16_BIT>
 class Reverb {
+ private:
+  typedef ReverbLayout<sample_rate> Layout;
+  typedef FxEngine<Layout::memory_size, format> E;
+  
  public:
+  typedef typename E::T T;
+  
+  enum {
+    buffer_size = Layout::memory_size
+  };
+  
   Reverb() { }
   ~Reverb() { }
   
-  void Init(uint16_t* buffer, float sr) {
+  void Init(T* buffer, float sr) {
     engine_.Init(buffer);
     engine_.SetLFOFrequency(LFO_1, 0.5f / sr);
     engine_.SetLFOFrequency(LFO_2, 0.3f / sr);
@@ -57,27 +104,30 @@ class Reverb {
     // (4 AP diffusers on the input, then a loop of 2x 2AP+1Delay).
     // Modulation is applied in the loop of the first diffuser AP for additional
     // smearing; and to the two long delays for a slow shimmer/chorus effect.
-    typedef E::Reserve<150,
-      E::Reserve<214,
-      E::Reserve<319,
-      E::Reserve<527,
-      E::Reserve<2182,
-      E::Reserve<2690,
-      E::Reserve<4501,
-      E::Reserve<2525,
-      E::Reserve<2197,
-      E::Reserve<6312> > > > > > > > > > Memory;
-    E::DelayLine<Memory, 0> ap1;
-    E::DelayLine<Memory, 1> ap2;
-    E::DelayLine<Memory, 2> ap3;
-    E::DelayLine<Memory, 3> ap4;
-    E::DelayLine<Memory, 4> dap1a;
-    E::DelayLine<Memory, 5> dap1b;
-    E::DelayLine<Memory, 6> del1;
-    E::DelayLine<Memory, 7> dap2a;
-    E::DelayLine<Memory, 8> dap2b;
-    E::DelayLine<Memory, 9> del2;
-    E::Context c;
+    typedef typename E::template Reserve<Scale<150>::value,
+      typename E::template Reserve<Scale<214>::value,
+      typename E::template Reserve<Scale<319>::value,
+      typename E::template Reserve<Scale<527>::value,
+      typename E::template Reserve<Scale<2182>::value,
+      typename E::template Reserve<Scale<2690>::value,
+      typename E::template Reserve<Scale<4501>::value,
+      typename E::template Reserve<Scale<2525>::value,
+      typename E::template Reserve<Scale<2197>::value,
+      typename E::template Reserve<Scale<6312>::value> > > > > > > > > > Memory;
+    typename E::template DelayLine<Memory, 0> ap1;
+    typename E::template DelayLine<Memory, 1> ap2;
+    typename E::template DelayLine<Memory, 2> ap3;
+    typename E::template DelayLine<Memory, 3> ap4;
+    typename E::template DelayLine<Memory, 4> dap1a;
+    typename E::template DelayLine<Memory, 5> dap1b;
+    typename E::template DelayLine<Memory, 6> del1;
+    typename E::template DelayLine<Memory, 7> dap2a;
+    typename E::template DelayLine<Memory, 8> dap2b;
+    typename E::template DelayLine<Memory, 9> del2;
+    typename E::Context c;
+    
+    // LFO excursions scale with the delay lines.
+    const float kScale = static_cast<float>(sample_rate) / 32000.0f;
 
     const float kap = diffusion_;
     const float klp = lp_;
@@ -120,7 +170,7 @@ class Reverb {
       
       // Main reverb loop.
       c.Load(apout);
-      c.Interpolate(del2, 6261.0f, LFO_2, 50.0f, krt);
+      c.Interpolate(del2, Scale<6261>::value, LFO_2, 50.0f * kScale, krt);
       c.Lp(lp_1, klp);
       c.Read(dap1a TAIL, -kap);
       c.WriteAllPass(dap1a, kap);
@@ -133,7 +183,7 @@ class Reverb {
       *left += (wet - *left) * amount;
 
       c.Load(apout);
-        c.Interpolate(del1, 4460.0f, LFO_1, 40.0f, krt);    // TODO: do we have a problem?
+        c.Interpolate(del1, Scale<4460>::value, LFO_1, 40.0f * kScale, krt);    // TODO: do we have a problem?
       //c.Read(del1 TAIL, krt);
       c.Lp(lp_2, klp);
       c.Read(dap2a TAIL, kap);
@@ -191,7 +241,9 @@ class Reverb {
   }
   
  private:
-  typedef FxEngine<32768, FORMAT_16_BIT> E;
+  template<int32_t length>
+  struct Scale : public Layout::template Scale<length> { };
+  
   E engine_;
   
   float amount_;
@@ -32,12 +32,20 @@
 
 #include "warps/dsp/modulator.h"
 
+#include <new>
+
 
 
 const size_t kBlockSize = 60; //    96;
+// the vocoder's filter bank decimates by 3 and 4, so blocks must be multiples of 12
+const size_t kBlockSizeStep = 12;
 
 static InterfaceTable *ft;
 
+#include "MiProfile.h"     // needs ft
+
+MI_PROFILER(gProfiler, "MiWarps", "algorithm", 9);
+
 
 struct MiWarps : public Unit {
     
@@ -49,6 +57,7 @@ struct MiWarps : public Unit {
     float               *silence;
     
     uint16_t            count;
+    uint16_t            block_size;
     
 };
 
@@ -56,32 +65,65 @@ struct MiWarps : public Unit {
 static void MiWarps_Ctor(MiWarps *unit);
 static void MiWarps_Dtor(MiWarps *unit);
 static void MiWarps_next(MiWarps *unit, int inNumSamples);
+static void MiWarps_next_planar(MiWarps *unit, int inNumSamples);
 
 
 static void MiWarps_Ctor(MiWarps *unit) {
 /*
     if (BUFLENGTH < kBlockSize) {
         Print("MiWarps ERROR: sc block size too small!\n");
-        unit = NULL;
+        SETCALC(ClearUnitOutputs);
+        ClearUnitOutputs(unit, 1);
         return;
     }
  */
     
-    unit->modulator = new warps::Modulator;
+    unit->modulator = NULL;
+    unit->input = NULL;
+    unit->output = NULL;
+    unit->silence = NULL;
+    
+    // internal block size: rounded to a multiple of 12, 12..96
+    int block_size = unit->mNumInputs > 10 ? static_cast<int>(IN0(10)) : kBlockSize;
+    block_size = (block_size + kBlockSizeStep / 2) / kBlockSizeStep * kBlockSizeStep;
+    CONSTRAIN(block_size, (int)kBlockSizeStep, (int)warps::kMaxBlockSize);
+    unit->block_size = block_size;
+    
+    // if the server block is a whole number of internal blocks, the modulator
+    // can run straight on the in/out buffers. otherwise go through a ring buffer
+    // of one internal block, which adds block_size - 1 samples of latency.
+    bool planar = (BUFLENGTH % block_size) == 0;
+    
+    unit->modulator = (warps::Modulator*)RTAlloc(unit->mWorld, sizeof(warps::Modulator));
+    unit->silence = (float*)RTAlloc(unit->mWorld, warps::kMaxBlockSize*sizeof(float));
+    if(!planar) {
+        unit->input = (warps::FloatFrame*)RTAlloc(unit->mWorld, warps::kMaxBlockSize*sizeof(warps::FloatFrame));
+        unit->output = (warps::FloatFrame*)RTAlloc(unit->mWorld, warps::kMaxBlockSize*sizeof(warps::FloatFrame));
+    }
+    if(unit->modulator == NULL || unit->silence == NULL ||
+       (!planar && (unit->input == NULL || unit->output == NULL))) {
+        Print("MiWarps ERROR: mem alloc failed!\n");
+        SETCALC(ClearUnitOutputs);
+        ClearUnitOutputs(unit, 1);
+        return;
+    }
+    
     memset(unit->modulator, 0, sizeof(*unit->modulator));
+    new(unit->modulator) warps::Modulator;
     unit->modulator->Init(SAMPLERATE);
     
-
-    unit->input = (warps::FloatFrame*)RTAlloc(unit->mWorld, warps::kMaxBlockSize*sizeof(warps::FloatFrame));
-    unit->output = (warps::FloatFrame*)RTAlloc(unit->mWorld, warps::kMaxBlockSize*sizeof(warps::FloatFrame));
-    memset(unit->output, 0, warps::kMaxBlockSize*sizeof(warps::FloatFrame));
-    unit->silence = (float*)RTAlloc(unit->mWorld, warps::kMaxBlockSize*sizeof(float));
+    if(!planar)
+        memset(unit->output, 0, warps::kMaxBlockSize*sizeof(warps::FloatFrame));
     memset(unit->silence, 0, warps::kMaxBlockSize*sizeof(float));
     
     unit->count = 0;
     
-    SETCALC(MiWarps_next);
-    MiWarps_next(unit, 64);
+    if(planar)
+        SETCALC(MiWarps_next_planar);
+    else
+        SETCALC(MiWarps_next);
+    ClearUnitOutputs(unit, 1);
+    //MiWarps_next(unit, 64);
 
 }
 
@@ -95,18 +137,16 @@ static void MiWarps_Dtor(MiWarps *unit) {
     if(unit->silence)
         RTFree(unit->mWorld, unit->silence);
     
-    if(unit->modulator)
-        delete unit->modulator;
+    if(unit->modulator) {
+        unit->modulator->~Modulator();
+        RTFree(unit->mWorld, unit->modulator);
+    }
 
 }
 
 
-
-void MiWarps_next( MiWarps *unit, int inNumSamples)
+static inline void MiWarps_SetParameters(MiWarps *unit)
 {
-    float   *carrier = IN(0);
-    float   *modulator = IN(1);
-    
     float   level1 = IN0(2);
     float   level2 = IN0(3);
     float   algorithm = IN0(4) * 0.125f;
@@ -116,14 +156,6 @@ void MiWarps_next( MiWarps *unit, int inNumSamples)
     float   pre_gain = IN0(8);
     bool    easter_egg = (IN0(9) > 0.f);
     
-    float   *out = OUT(0);
-    float   *aux = OUT(1);
-    
-    uint16_t count = unit->count;
-    
-    warps::FloatFrame  *input = unit->input;
-    warps::FloatFrame  *output = unit->output;
-    
     warps::Parameters *p = unit->modulator->mutable_parameters();
     
     CONSTRAIN(level1, 0.f, 1.f);
@@ -158,6 +190,24 @@ void MiWarps_next( MiWarps *unit, int inNumSamples)
     
     
     //unit->modulator->set_bypass(true);
+}
+
+
+void MiWarps_next( MiWarps *unit, int inNumSamples)
+{
+    float   *carrier = IN(0);
+    float   *modulator = IN(1);
+    
+    float   *out = OUT(0);
+    float   *aux = OUT(1);
+    
+    uint16_t count = unit->count;
+    uint16_t block_size = unit->block_size;
+    
+    warps::FloatFrame  *input = unit->input;
+    warps::FloatFrame  *output = unit->output;
+    
+    MiWarps_SetParameters(unit);
     
     if( INRATE(0) != calc_FullRate)
         carrier = unit->silence;
@@ -170,8 +220,9 @@ void MiWarps_next( MiWarps *unit, int inNumSamples)
         input[count].r = modulator[i];
 
         count++;
-        if(count >= kBlockSize) {
-            unit->modulator->Processf(input, output, kBlockSize);
+        if(count >= block_size) {
+            MI_PROFILE_SCOPE(gProfiler, int(IN0(4)), block_size);
+            unit->modulator->Processf(input, output, block_size);
             count = 0;
         }
 
@@ -184,9 +235,45 @@ void MiWarps_next( MiWarps *unit, int inNumSamples)
 }
 
 
+// server block size is a multiple of the internal block size:
+// no copies, no added latency
+void MiWarps_next_planar( MiWarps *unit, int inNumSamples)
+{
+    float   *input[2] = { IN(0), IN(1) };
+    float   *output[2] = { OUT(0), OUT(1) };
+    
+    size_t  block_size = unit->block_size;
+    size_t  input_stride[2] = { block_size, block_size };
+    
+    MiWarps_SetParameters(unit);
+    
+    for (int i=0; i<2; ++i) {
+        if( INRATE(i) != calc_FullRate) {
+            input[i] = unit->silence;
+            input_stride[i] = 0;
+        }
+    }
+    
+    for (int n = 0; n < inNumSamples; n += block_size) {
+        
+        {
+            MI_PROFILE_SCOPE(gProfiler, int(IN0(4)), block_size);
+            unit->modulator->Processff(input, output, block_size);
+        }
+        
+        input[0] += input_stride[0];
+        input[1] += input_stride[1];
+        output[0] += block_size;
+        output[1] += block_size;
+    }
+
+}
+
+
 PluginLoad(MiWarps) {
     ft = inTable;
     DefineDtorUnit(MiWarps);
+    MI_PROFILE_COMMAND("miWarpsProfile");
 }
 
 
@@ -4,14 +4,17 @@ MiClouds : MultiOutUGen {
 
 	*ar {
 		arg inputArray, pit=0, pos=0.5, size=0.25, dens=0.4, tex=0.5, drywet=0.5, in_gain=1,
-		spread=0.5, rvb=0, fb=0, freeze=0, mode=0, lofi=0, trig=0, mul=1.0, add=0.0;
+		spread=0.5, rvb=0, fb=0, freeze=0, mode=0, lofi=0, trig=0, latency=0, seed=0, bufnum=(-1), mul=1.0, add=0.0;
 		^this.multiNewList(['audio', pit, pos, size, dens, tex, drywet, in_gain, spread, rvb, fb,
-			freeze, mode, lofi, trig] ++ inputArray.asArray).madd(mul);
+			freeze, mode, lofi, trig, latency, seed, bufnum] ++ inputArray.asArray).madd(mul);
+	}
+	*profile { arg path, reset=0, server;
+		(server ? Server.default).sendMsg(\cmd, \miCloudsProfile, (path ? "").standardizePath, reset);
 	}
 
 	checkInputs {
-		if ( inputs.at(14).rate != 'audio', {
-			^("input is not audio rate:" + inputs.at(14) + inputs.at(14).rate);
+		if ( inputs.at(17).rate != 'audio', {
+			^("input is not audio rate:" + inputs.at(17) + inputs.at(17).rate);
 		});
 		^this.checkValidInputs;
 	}
@@ -12,6 +12,9 @@ MiOmi : MultiOutUGen {
 			level1, level2, ratio1, ratio2, fm1, fm2, fb, xfb, filter_mode,
 			cutoff, reson, strength, env, rotate, space).madd(mul, add);
 	}
+	*profile { arg path, reset=0, server;
+		(server ? Server.default).sendMsg(\cmd, \miOmiProfile, (path ? "").standardizePath, reset);
+	}
 
 	init { arg ... theInputs;
 		inputs = theInputs;
@@ -4,10 +4,31 @@ MiPlaits : MultiOutUGen {
 
 	*ar {
 		arg pitch=60.0, engine=0, harm=0.1, timbre=0.5, morph=0.5, trigger=0.0, level=0, fm_mod=0.0, timb_mod=0.0,
-		morph_mod=0.0, decay=0.5, lpg_colour=0.5, mul=1.0;
+		morph_mod=0.0, decay=0.5, lpg_colour=0.5, seed=0, bank=(-1), mul=1.0;
 		^this.multiNew('audio', pitch, engine, harm, timbre, morph, trigger, level, fm_mod, timb_mod, morph_mod,
-			decay, lpg_colour).madd(mul);
+			decay, lpg_colour, seed, bank).madd(mul);
 	}
+	*profile { arg path, reset=0, server;
+		(server ? Server.default).sendMsg(\cmd, \miPlaitsProfile, (path ? "").standardizePath, reset);
+	}
+	// preallocate 'size' voices on the server, 0 frees them
+	*poolSize { arg size=16, server;
+		(server ? Server.default).sendMsg(\cmd, \miPlaitsPool, size);
+	}
+	// unpack the DX7 bank held by 'buffer' for the six-op engines
+	*loadBank { arg buffer, server;
+		(server ? Server.default).sendMsg(\cmd, \miPlaitsBank, buffer.asUGenInput);
+	}
+	// read a DX7 bank from a .syx file into a new Buffer, and load it
+	*readBank { arg path, server, action;
+		var bytes = File.use(path.standardizePath, "rb", { |f| Array.fill(f.length, { f.getInt8 }) });
+		server = server ? Server.default;
+		^Buffer.loadCollection(server, bytes, 1, { |buf|
+			this.loadBank(buf, server);
+			action.value(buf);
+		});
+	}
+
 	//checkInputs { ^this.checkSameRateAsFirstInput }
 
 	init { arg ... theInputs;
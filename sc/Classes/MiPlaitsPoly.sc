@@ -0,0 +1,19 @@
+MiPlaitsPoly : MultiOutUGen {
+
+	*ar {
+		arg pitch=60.0, engine=0, harm=0.1, timbre=0.5, morph=0.5, trigger=0.0, level=0, fm_mod=0.0, timb_mod=0.0,
+		morph_mod=0.0, decay=0.5, lpg_colour=0.5, seed=0, bank=(-1), mul=1.0;
+		// one voice per element of the largest of the pitch, trigger and level arrays
+		var numVoices = [pitch, trigger, level].collect { |x| x.asArray.size }.maxItem;
+		^this.multiNewList(['audio', numVoices, engine, harm, timbre, morph, fm_mod, timb_mod, morph_mod,
+			decay, lpg_colour, seed, bank]
+			++ pitch.asArray.wrapExtend(numVoices)
+			++ trigger.asArray.wrapExtend(numVoices)
+			++ level.asArray.wrapExtend(numVoices)).madd(mul);
+	}
+
+	init { arg ... theInputs;
+		inputs = theInputs;
+		^this.initOutputs(2, rate);
+	}
+}
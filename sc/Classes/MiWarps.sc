@@ -3,11 +3,14 @@
 MiWarps : MultiOutUGen {
 
 	*ar {
-		arg carrier=0, modulator=0, lev1=0.5, lev2=0.5, algo=0, timb=0, osc=0, freq=110, vgain=1, easteregg=0; //, mul=1.0, add=0;
+		arg carrier=0, modulator=0, lev1=0.5, lev2=0.5, algo=0, timb=0, osc=0, freq=110, vgain=1, easteregg=0, blocksize=60; //, mul=1.0, add=0;
 
-		^this.multiNew('audio', carrier, modulator, lev1, lev2, algo, timb, osc, freq, vgain, easteregg);
+		^this.multiNew('audio', carrier, modulator, lev1, lev2, algo, timb, osc, freq, vgain, easteregg, blocksize);
 		//.madd(mul, add);
 	}
+	*profile { arg path, reset=0, server;
+		(server ? Server.default).sendMsg(\cmd, \miWarpsProfile, (path ? "").standardizePath, reset);
+	}
 	/*
 	checkInputs {
 		if ( inputs.at(0).rate == 'control', {